@@ -13,7 +13,8 @@ public class ActionRPG : ModuleRules
 			new string[] {
 				"Core",
 				"CoreUObject",
-				"Engine"
+				"Engine",
+				"NetCore"
 			}
 		);
 
@@ -29,7 +30,9 @@ public class ActionRPG : ModuleRules
 				"GameplayTasks",
 				"AIModule",
 				"StateTreeModule",
-				"NavigationSystem"
+				"NavigationSystem",
+				"AnimationBudgetAllocator",
+				"Json"
 			}
 		);
 
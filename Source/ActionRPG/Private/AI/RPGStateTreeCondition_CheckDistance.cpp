@@ -1,4 +1,6 @@
 #include "AI/RPGStateTreeCondition_CheckDistance.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
 #include "StateTreeExecutionContext.h"
 #include "RPGCharacterBase.h"
 #include "Kismet/GameplayStatics.h"
@@ -6,6 +8,8 @@
 
 bool FRPGStateTreeCondition_CheckDistance::TestCondition(FStateTreeExecutionContext& Context) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	const FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	AActor* Actor = InstanceData.TargetActor;
@@ -18,6 +22,7 @@ bool FRPGStateTreeCondition_CheckDistance::TestCondition(FStateTreeExecutionCont
 	AActor* Target = nullptr;
 	TArray<AActor*> FoundActors;
 	UGameplayStatics::GetAllActorsOfClass(Actor->GetWorld(), ARPGCharacterBase::StaticClass(), FoundActors);
+	RPGStats::RecordTargetSearch(FoundActors.Num());
 	
 	float MinDistSq = MAX_FLT;
 	for (AActor* FoundActor : FoundActors)
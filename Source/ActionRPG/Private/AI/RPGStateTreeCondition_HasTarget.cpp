@@ -1,4 +1,7 @@
 #include "AI/RPGStateTreeCondition_HasTarget.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
+#include "RPGBatchedTickSubsystem.h"
 #include "RPGCharacterBase.h"
 #include "RPGArcherCharacter.h"
 #include "RPGArcherEnemy.h"
@@ -8,6 +11,8 @@
 
 bool FRPGStateTreeCondition_HasTarget::TestCondition(FStateTreeExecutionContext& Context) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	AActor* Actor = InstanceData.TargetActor;
@@ -42,13 +47,24 @@ bool FRPGStateTreeCondition_HasTarget::TestCondition(FStateTreeExecutionContext&
 
 AActor* FRPGStateTreeCondition_HasTarget::FindNearestTarget(AActor* SearchOrigin, float Range) const
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_FindNearestTarget);
+
 	if (!SearchOrigin)
 	{
 		return nullptr;
 	}
 
+	// Answered from the perception batch once it has seen this agent
+	AActor* PerceivedTarget = nullptr;
+	URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(SearchOrigin);
+	if (BatchedTick && BatchedTick->GetPerception().FindNearestTarget(SearchOrigin, Range, PerceivedTarget))
+	{
+		return PerceivedTarget;
+	}
+
 	TArray<AActor*> FoundActors;
 	UGameplayStatics::GetAllActorsOfClass(SearchOrigin->GetWorld(), ARPGCharacterBase::StaticClass(), FoundActors);
+	RPGStats::RecordTargetSearch(FoundActors.Num());
 
 	AActor* NearestTarget = nullptr;
 	float MinDistanceSq = FMath::Square(Range);
@@ -1,4 +1,7 @@
 #include "AI/RPGStateTreeTask_ChasePlayer.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
+#include "RPGBatchedTickSubsystem.h"
 #include "AIController.h"
 #include "RPGArcherCharacter.h"
 #include "RPGArcherEnemy.h"
@@ -14,6 +17,8 @@ FRPGStateTreeTask_ChasePlayer::FRPGStateTreeTask_ChasePlayer()
 
 EStateTreeRunStatus FRPGStateTreeTask_ChasePlayer::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	UE_LOG(LogTemp, Warning, TEXT("[ChasePlayer] EnterState called!"));
@@ -52,6 +57,17 @@ EStateTreeRunStatus FRPGStateTreeTask_ChasePlayer::EnterState(FStateTreeExecutio
 	{
 		AIController->MoveToActor(Target, InstanceData.AcceptanceRadius);
 		UE_LOG(LogTemp, Warning, TEXT("[ChasePlayer] Start chasing target: %s"), *Target->GetName());
+
+		// 之后由决策批处理持续追击
+		if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::GetForAIDecisions(Actor))
+		{
+			if (APawn* Pawn = Cast<APawn>(Actor))
+			{
+				FRPGChaseDecisionItem& Item = BatchedTick->GetChaseDecisions().Register(Pawn, Target);
+				Item.AcceptanceRadius = InstanceData.AcceptanceRadius;
+			}
+		}
+
 		return EStateTreeRunStatus::Running;
 	}
 
@@ -61,6 +77,8 @@ EStateTreeRunStatus FRPGStateTreeTask_ChasePlayer::EnterState(FStateTreeExecutio
 
 EStateTreeRunStatus FRPGStateTreeTask_ChasePlayer::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	AActor* Actor = InstanceData.TargetActor;
@@ -71,6 +89,12 @@ EStateTreeRunStatus FRPGStateTreeTask_ChasePlayer::Tick(FStateTreeExecutionConte
 		return EStateTreeRunStatus::Failed;
 	}
 
+	URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::GetForAIDecisions(Actor);
+	if (BatchedTick && BatchedTick->GetChaseDecisions().IsRegistered(Actor))
+	{
+		return BatchedTick->GetChaseDecisions().GetStatus(Actor);
+	}
+
 	// 持续追击目标
 	if (AAIController* AIController = Cast<AAIController>(Actor->GetInstigatorController()))
 	{
@@ -87,6 +111,11 @@ void FRPGStateTreeTask_ChasePlayer::ExitState(FStateTreeExecutionContext& Contex
 	AActor* Actor = InstanceData.TargetActor;
 	if (Actor)
 	{
+		if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(Actor))
+		{
+			BatchedTick->GetChaseDecisions().Unregister(Actor);
+		}
+
 		if (AAIController* AIController = Cast<AAIController>(Actor->GetInstigatorController()))
 		{
 			AIController->StopMovement();
@@ -98,13 +127,24 @@ void FRPGStateTreeTask_ChasePlayer::ExitState(FStateTreeExecutionContext& Contex
 
 AActor* FRPGStateTreeTask_ChasePlayer::FindNearestTarget(AActor* SearchOrigin, float Range) const
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_FindNearestTarget);
+
 	if (!SearchOrigin)
 	{
 		return nullptr;
 	}
 
+	// Answered from the perception batch once it has seen this agent
+	AActor* PerceivedTarget = nullptr;
+	URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(SearchOrigin);
+	if (BatchedTick && BatchedTick->GetPerception().FindNearestTarget(SearchOrigin, Range, PerceivedTarget))
+	{
+		return PerceivedTarget;
+	}
+
 	TArray<AActor*> FoundActors;
 	UGameplayStatics::GetAllActorsOfClass(SearchOrigin->GetWorld(), ARPGCharacterBase::StaticClass(), FoundActors);
+	RPGStats::RecordTargetSearch(FoundActors.Num());
 
 	AActor* NearestTarget = nullptr;
 	float MinDistanceSq = FMath::Square(Range);
@@ -1,4 +1,7 @@
 #include "AI/RPGStateTreeTask_FireArrow.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
+#include "RPGBatchedTickSubsystem.h"
 #include "AIController.h"
 #include "RPGArcherCharacter.h"
 #include "RPGArcherEnemy.h"
@@ -15,6 +18,8 @@ FRPGStateTreeTask_FireArrow::FRPGStateTreeTask_FireArrow()
 
 EStateTreeRunStatus FRPGStateTreeTask_FireArrow::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	AActor* Actor = InstanceData.TargetActor;
@@ -41,12 +46,26 @@ EStateTreeRunStatus FRPGStateTreeTask_FireArrow::EnterState(FStateTreeExecutionC
 	InstanceData.TimeSinceLastAttack = InstanceData.AttackCooldown;
 	FireArrow(InstanceData, Target);
 
+	// 之后的转向和射击由决策批处理完成
+	if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::GetForAIDecisions(Actor))
+	{
+		if (APawn* Pawn = Cast<APawn>(Actor))
+		{
+			FRPGFireArrowDecisionItem& Item = BatchedTick->GetFireArrowDecisions().Register(Pawn, Target);
+			Item.ArrowProjectileClass = InstanceData.ArrowProjectileClass;
+			Item.AttackCooldown = InstanceData.AttackCooldown;
+			Item.TimeSinceLastAttack = InstanceData.TimeSinceLastAttack;
+		}
+	}
+
 	UE_LOG(LogTemp, Warning, TEXT("[FireArrow] EnterState: Start attacking target %s"), *Target->GetName());
 	return EStateTreeRunStatus::Running;
 }
 
 EStateTreeRunStatus FRPGStateTreeTask_FireArrow::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	AActor* Actor = InstanceData.TargetActor;
@@ -57,6 +76,12 @@ EStateTreeRunStatus FRPGStateTreeTask_FireArrow::Tick(FStateTreeExecutionContext
 		return EStateTreeRunStatus::Failed;
 	}
 
+	URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::GetForAIDecisions(Actor);
+	if (BatchedTick && BatchedTick->GetFireArrowDecisions().IsRegistered(Actor))
+	{
+		return BatchedTick->GetFireArrowDecisions().GetStatus(Actor);
+	}
+
 	// 更新冷却时间
 	InstanceData.TimeSinceLastAttack += DeltaTime;
 
@@ -75,24 +100,38 @@ EStateTreeRunStatus FRPGStateTreeTask_FireArrow::Tick(FStateTreeExecutionContext
 	return EStateTreeRunStatus::Running;
 }
 
+void FRPGStateTreeTask_FireArrow::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(InstanceData.TargetActor))
+	{
+		BatchedTick->GetFireArrowDecisions().Unregister(InstanceData.TargetActor);
+	}
+}
+
 void FRPGStateTreeTask_FireArrow::FireArrow(const FInstanceDataType& InstanceData, AActor* Target) const
 {
-	AActor* Actor = InstanceData.TargetActor;
+	SpawnArrow(InstanceData.TargetActor, Target, InstanceData.ArrowProjectileClass);
+}
 
+void FRPGStateTreeTask_FireArrow::SpawnArrow(AActor* Actor, AActor* Target, TSubclassOf<ARPGArrowProjectile> ArrowProjectileClass)
+{
 	if (!Actor || !Target)
 	{
 		UE_LOG(LogTemp, Error, TEXT("[FireArrow] FireArrow: Actor or Target is NULL!"));
 		return;
 	}
 
-	if (!InstanceData.ArrowProjectileClass)
+	if (!ArrowProjectileClass)
 	{
 		UE_LOG(LogTemp, Error, TEXT("[FireArrow] FireArrow: ArrowProjectileClass is not set!"));
 		return;
 	}
 
 	// 生成箭矢
-	FVector SpawnLocation = Actor->GetActorLocation() + Actor->GetActorForwardVector() * 100.0f + FVector(0, 0, 50.0f);
+	const ARPGArcherEnemy* Archer = Cast<ARPGArcherEnemy>(Actor);
+	FVector SpawnLocation = Archer ? Archer->GetProjectileSpawnLocation() : Actor->GetActorLocation() + Actor->GetActorForwardVector() * 100.0f + FVector(0, 0, 50.0f);
 	FRotator SpawnRotation = (Target->GetActorLocation() - SpawnLocation).Rotation();
 
 	FActorSpawnParameters SpawnParams;
@@ -101,7 +140,7 @@ void FRPGStateTreeTask_FireArrow::FireArrow(const FInstanceDataType& InstanceDat
 
 	if (UWorld* World = Actor->GetWorld())
 	{
-		ARPGArrowProjectile* Arrow = World->SpawnActor<ARPGArrowProjectile>(InstanceData.ArrowProjectileClass, SpawnLocation, SpawnRotation, SpawnParams);
+		ARPGArrowProjectile* Arrow = World->SpawnActor<ARPGArrowProjectile>(ArrowProjectileClass, SpawnLocation, SpawnRotation, SpawnParams);
 		if (Arrow)
 		{
 			UE_LOG(LogTemp, Warning, TEXT("[FireArrow] Spawned arrow projectile at %s"), *SpawnLocation.ToString());
@@ -115,13 +154,24 @@ void FRPGStateTreeTask_FireArrow::FireArrow(const FInstanceDataType& InstanceDat
 
 AActor* FRPGStateTreeTask_FireArrow::FindNearestTarget(AActor* SearchOrigin, float Range) const
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_FindNearestTarget);
+
 	if (!SearchOrigin)
 	{
 		return nullptr;
 	}
 
+	// Answered from the perception batch once it has seen this agent
+	AActor* PerceivedTarget = nullptr;
+	URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(SearchOrigin);
+	if (BatchedTick && BatchedTick->GetPerception().FindNearestTarget(SearchOrigin, Range, PerceivedTarget))
+	{
+		return PerceivedTarget;
+	}
+
 	TArray<AActor*> FoundActors;
 	UGameplayStatics::GetAllActorsOfClass(SearchOrigin->GetWorld(), ARPGCharacterBase::StaticClass(), FoundActors);
+	RPGStats::RecordTargetSearch(FoundActors.Num());
 
 	AActor* NearestTarget = nullptr;
 	float MinDistanceSq = FMath::Square(Range);
@@ -1,4 +1,6 @@
 #include "AI/RPGStateTreeTask_RandomPatrol.h"
+#include "RPGBenchmark.h"
+#include "RPGBatchedTickSubsystem.h"
 #include "AIController.h"
 #include "NavigationSystem.h"
 #include "RPGArcherCharacter.h"
@@ -12,6 +14,8 @@ FRPGStateTreeTask_RandomPatrol::FRPGStateTreeTask_RandomPatrol()
 
 EStateTreeRunStatus FRPGStateTreeTask_RandomPatrol::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	AActor* Actor = InstanceData.TargetActor;
@@ -75,6 +79,12 @@ EStateTreeRunStatus FRPGStateTreeTask_RandomPatrol::EnterState(FStateTreeExecuti
 		return EStateTreeRunStatus::Failed;
 	}
 	
+	// 后续巡逻点由巡逻批处理选择，Tick 不再逐个检查
+	if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(Actor))
+	{
+		BatchedTick->GetPatrol().Register(AIController, InstanceData.CurrentPatrolLocation, InstanceData.PatrolRadius);
+	}
+
 	if (MoveResult.Code == EPathFollowingRequestResult::AlreadyAtGoal)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("[RandomPatrol] System thinks we're already at goal! Distance is %f but acceptance radius is 50.0"), ActualDistance);
@@ -88,6 +98,8 @@ EStateTreeRunStatus FRPGStateTreeTask_RandomPatrol::EnterState(FStateTreeExecuti
 
 EStateTreeRunStatus FRPGStateTreeTask_RandomPatrol::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	AActor* Actor = InstanceData.TargetActor;
@@ -102,6 +114,13 @@ EStateTreeRunStatus FRPGStateTreeTask_RandomPatrol::Tick(FStateTreeExecutionCont
 		return EStateTreeRunStatus::Failed;
 	}
 
+	// 巡逻批处理负责到达检测和选择新巡逻点
+	URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(Actor);
+	if (BatchedTick && BatchedTick->GetPatrol().IsRegistered(Actor))
+	{
+		return EStateTreeRunStatus::Running;
+	}
+
 	// 检查是否到达巡逻点
 	float DistanceToTarget = FVector::Dist(Actor->GetActorLocation(), InstanceData.CurrentPatrolLocation);
 	
@@ -144,6 +163,11 @@ void FRPGStateTreeTask_RandomPatrol::ExitState(FStateTreeExecutionContext& Conte
 	AActor* Actor = InstanceData.TargetActor;
 	if (Actor)
 	{
+		if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(Actor))
+		{
+			BatchedTick->GetPatrol().Unregister(Actor);
+		}
+
 		if (AAIController* AIController = Cast<AAIController>(Actor->GetInstigatorController()))
 		{
 			AIController->StopMovement();
@@ -151,7 +175,7 @@ void FRPGStateTreeTask_RandomPatrol::ExitState(FStateTreeExecutionContext& Conte
 	}
 }
 
-FVector FRPGStateTreeTask_RandomPatrol::GetRandomPatrolLocation(const FVector& Origin, float Radius, UObject* WorldContext) const
+FVector FRPGStateTreeTask_RandomPatrol::GetRandomPatrolLocation(const FVector& Origin, float Radius, UObject* WorldContext)
 {
 	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(WorldContext);
 	if (NavSys)
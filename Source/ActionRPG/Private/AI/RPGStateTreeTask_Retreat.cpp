@@ -1,4 +1,7 @@
 #include "AI/RPGStateTreeTask_Retreat.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
+#include "RPGBatchedTickSubsystem.h"
 #include "AIController.h"
 #include "RPGArcherCharacter.h"
 #include "RPGCharacterBase.h"
@@ -12,6 +15,8 @@ FRPGStateTreeTask_Retreat::FRPGStateTreeTask_Retreat()
 
 EStateTreeRunStatus FRPGStateTreeTask_Retreat::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	AActor* Actor = InstanceData.TargetActor;
@@ -49,6 +54,18 @@ EStateTreeRunStatus FRPGStateTreeTask_Retreat::EnterState(FStateTreeExecutionCon
 	if (AAIController* AIController = Cast<AAIController>(Actor->GetInstigatorController()))
 	{
 		AIController->MoveToLocation(InstanceData.RetreatLocation, 100.0f);
+
+		// 之后由决策批处理检查是否撤退完成
+		if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::GetForAIDecisions(Actor))
+		{
+			if (APawn* Pawn = Cast<APawn>(Actor))
+			{
+				FRPGRetreatDecisionItem& Item = BatchedTick->GetRetreatDecisions().Register(Pawn, Target);
+				Item.RetreatLocation = InstanceData.RetreatLocation;
+				Item.RetreatDistance = InstanceData.RetreatDistance;
+			}
+		}
+
 		return EStateTreeRunStatus::Running;
 	}
 
@@ -57,6 +74,8 @@ EStateTreeRunStatus FRPGStateTreeTask_Retreat::EnterState(FStateTreeExecutionCon
 
 EStateTreeRunStatus FRPGStateTreeTask_Retreat::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
+	RPG_BENCHMARK_SCOPE(AITick);
+
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	AActor* Actor = InstanceData.TargetActor;
@@ -67,6 +86,12 @@ EStateTreeRunStatus FRPGStateTreeTask_Retreat::Tick(FStateTreeExecutionContext&
 		return EStateTreeRunStatus::Failed;
 	}
 
+	URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::GetForAIDecisions(Actor);
+	if (BatchedTick && BatchedTick->GetRetreatDecisions().IsRegistered(Actor))
+	{
+		return BatchedTick->GetRetreatDecisions().GetStatus(Actor);
+	}
+
 	// 检查是否到达撤退位置或距离目标足够远
 	float DistanceToRetreatLocation = FVector::Dist(Actor->GetActorLocation(), InstanceData.RetreatLocation);
 	float DistanceToPlayer = FVector::Dist(Actor->GetActorLocation(), Target->GetActorLocation());
@@ -89,6 +114,11 @@ void FRPGStateTreeTask_Retreat::ExitState(FStateTreeExecutionContext& Context, c
 	AActor* Actor = InstanceData.TargetActor;
 	if (Actor)
 	{
+		if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(Actor))
+		{
+			BatchedTick->GetRetreatDecisions().Unregister(Actor);
+		}
+
 		if (AAIController* AIController = Cast<AAIController>(Actor->GetInstigatorController()))
 		{
 			AIController->StopMovement();
@@ -98,6 +128,8 @@ void FRPGStateTreeTask_Retreat::ExitState(FStateTreeExecutionContext& Context, c
 
 AActor* FRPGStateTreeTask_Retreat::FindNearestTarget(AActor* SearchOrigin, float Range) const
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_FindNearestTarget);
+
 	if (!SearchOrigin)
 	{
 		return nullptr;
@@ -105,6 +137,7 @@ AActor* FRPGStateTreeTask_Retreat::FindNearestTarget(AActor* SearchOrigin, float
 
 	TArray<AActor*> FoundActors;
 	UGameplayStatics::GetAllActorsOfClass(SearchOrigin->GetWorld(), ARPGCharacterBase::StaticClass(), FoundActors);
+	RPGStats::RecordTargetSearch(FoundActors.Num());
 
 	AActor* NearestTarget = nullptr;
 	float MinDistanceSq = FMath::Square(Range);
@@ -3,9 +3,117 @@
 #include "Abilities/RPGAbilitySystemComponent.h"
 #include "RPGCharacterBase.h"
 #include "Abilities/RPGGameplayAbility.h"
+#include "Abilities/RPGAbilityTask_PlayMontageAndWaitForEvent.h"
 #include "AbilitySystemGlobals.h"
 
-URPGAbilitySystemComponent::URPGAbilitySystemComponent() {}
+/** Montage tasks a component can have registered before the slot array grows, combos rarely have more than a couple */
+static const int32 PreallocatedMontageEventSlots = 8;
+
+URPGAbilitySystemComponent::URPGAbilitySystemComponent()
+	: NumMontageEventTasks(0)
+{
+	MontageEventTasks.Reserve(PreallocatedMontageEventSlots);
+	FreeMontageEventSlots.Reserve(PreallocatedMontageEventSlots);
+}
+
+int32 URPGAbilitySystemComponent::HandleGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload)
+{
+	const int32 TriggeredCount = Super::HandleGameplayEvent(EventTag, Payload);
+
+	if (NumMontageEventTasks > 0 && Payload)
+	{
+		RouteMontageEvent(EventTag, *Payload);
+	}
+
+	return TriggeredCount;
+}
+
+int32 URPGAbilitySystemComponent::RegisterMontageEventTask(URPGAbilityTask_PlayMontageAndWaitForEvent* Task, const FGameplayTagContainer& EventTags)
+{
+	int32 Slot;
+	if (FreeMontageEventSlots.Num() > 0)
+	{
+		Slot = FreeMontageEventSlots.Pop(EAllowShrinking::No);
+		MontageEventTasks[Slot] = Task;
+	}
+	else
+	{
+		Slot = MontageEventTasks.Add(Task);
+	}
+
+	if (EventTags.IsEmpty())
+	{
+		MontageEventWildcardSlots.Add(Slot);
+	}
+	else
+	{
+		for (const FGameplayTag& EventTag : EventTags)
+		{
+			MontageEventTagSlots.FindOrAdd(EventTag).Add(Slot);
+		}
+	}
+
+	NumMontageEventTasks++;
+	return Slot;
+}
+
+void URPGAbilitySystemComponent::UnregisterMontageEventTask(int32 Slot, const FGameplayTagContainer& EventTags)
+{
+	if (!MontageEventTasks.IsValidIndex(Slot) || MontageEventTasks[Slot].IsExplicitlyNull())
+	{
+		return;
+	}
+
+	if (EventTags.IsEmpty())
+	{
+		MontageEventWildcardSlots.RemoveSingleSwap(Slot, EAllowShrinking::No);
+	}
+	else
+	{
+		for (const FGameplayTag& EventTag : EventTags)
+		{
+			if (TArray<int32, TInlineAllocator<4>>* Slots = MontageEventTagSlots.Find(EventTag))
+			{
+				Slots->RemoveSingleSwap(Slot, EAllowShrinking::No);
+			}
+		}
+	}
+
+	MontageEventTasks[Slot].Reset();
+	FreeMontageEventSlots.Add(Slot);
+	NumMontageEventTasks--;
+}
+
+void URPGAbilitySystemComponent::RouteMontageEvent(FGameplayTag EventTag, const FGameplayEventData& Payload)
+{
+	// Gather first, a task can end and free its slot from inside its callback
+	TArray<URPGAbilityTask_PlayMontageAndWaitForEvent*, TInlineAllocator<8>> Receivers;
+
+	for (const int32 Slot : MontageEventWildcardSlots)
+	{
+		Receivers.AddUnique(MontageEventTasks[Slot].Get());
+	}
+
+	// Listening for a parent tag matches every child, like FGameplayTag::MatchesAny
+	for (FGameplayTag Tag = EventTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	{
+		if (const TArray<int32, TInlineAllocator<4>>* Slots = MontageEventTagSlots.Find(Tag))
+		{
+			for (const int32 Slot : *Slots)
+			{
+				Receivers.AddUnique(MontageEventTasks[Slot].Get());
+			}
+		}
+	}
+
+	for (URPGAbilityTask_PlayMontageAndWaitForEvent* Receiver : Receivers)
+	{
+		if (IsValid(Receiver))
+		{
+			Receiver->HandleRoutedGameplayEvent(EventTag, Payload);
+		}
+	}
+}
 
 void URPGAbilitySystemComponent::GetActiveAbilitiesWithTags(const FGameplayTagContainer& GameplayTagContainer, TArray<URPGGameplayAbility*>& ActiveAbilities)
 {
@@ -13,6 +13,7 @@ URPGAbilityTask_PlayMontageAndWaitForEvent::URPGAbilityTask_PlayMontageAndWaitFo
 {
 	Rate = 1.f;
 	bStopWhenAbilityEnds = true;
+	EventRouterSlot = INDEX_NONE;
 }
 
 URPGAbilitySystemComponent* URPGAbilityTask_PlayMontageAndWaitForEvent::GetTargetASC()
@@ -82,14 +83,22 @@ void URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageEnded(UAnimMontage* Mo
 	EndTask();
 }
 
-void URPGAbilityTask_PlayMontageAndWaitForEvent::OnGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload)
+void URPGAbilityTask_PlayMontageAndWaitForEvent::HandleRoutedGameplayEvent(FGameplayTag EventTag, const FGameplayEventData& Payload)
 {
 	if (ShouldBroadcastAbilityTaskDelegates())
 	{
-		FGameplayEventData TempData = *Payload;
-		TempData.EventTag = EventTag;
+		// Senders almost always fill in the tag, only copy the payload when it needs fixing up
+		if (Payload.EventTag == EventTag)
+		{
+			EventReceived.Broadcast(EventTag, Payload);
+		}
+		else
+		{
+			FGameplayEventData TempData = Payload;
+			TempData.EventTag = EventTag;
 
-		EventReceived.Broadcast(EventTag, TempData);
+			EventReceived.Broadcast(EventTag, TempData);
+		}
 	}
 }
 
@@ -125,8 +134,8 @@ void URPGAbilityTask_PlayMontageAndWaitForEvent::Activate()
 		UAnimInstance* AnimInstance = ActorInfo->GetAnimInstance();
 		if (AnimInstance != nullptr)
 		{
-			// Bind to event callback
-			EventHandle = RPGAbilitySystemComponent->AddGameplayEventTagContainerDelegate(EventTags, FGameplayEventTagMulticastDelegate::FDelegate::CreateUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnGameplayEvent));
+			// Receive events through the component's router
+			EventRouterSlot = RPGAbilitySystemComponent->RegisterMontageEventTask(this, EventTags);
 
 			if (RPGAbilitySystemComponent->PlayMontage(Ability, Ability->GetCurrentActivationInfo(), MontageToPlay, Rate, StartSection) > 0.f)
 			{
@@ -204,9 +213,10 @@ void URPGAbilityTask_PlayMontageAndWaitForEvent::OnDestroy(bool AbilityEnded)
 	}
 
 	URPGAbilitySystemComponent* RPGAbilitySystemComponent = GetTargetASC();
-	if (RPGAbilitySystemComponent)
+	if (RPGAbilitySystemComponent && EventRouterSlot != INDEX_NONE)
 	{
-		RPGAbilitySystemComponent->RemoveGameplayEventTagContainerDelegate(EventTags, EventHandle);
+		RPGAbilitySystemComponent->UnregisterMontageEventTask(EventRouterSlot, EventTags);
+		EventRouterSlot = INDEX_NONE;
 	}
 
 	Super::OnDestroy(AbilityEnded);
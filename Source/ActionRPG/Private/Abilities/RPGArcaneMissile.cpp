@@ -1,7 +1,10 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Abilities/RPGArcaneMissile.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
 #include "RPGCharacterBase.h"
+#include "RPGBatchedTickSubsystem.h"
 #include "Abilities/RPGAbilitySystemComponent.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
@@ -11,7 +14,9 @@
 
 ARPGArcaneMissile::ARPGArcaneMissile()
 {
+	// Homing is steered by the batched tick subsystem, the actor only ticks itself in worlds without one
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	// Create collision component
 	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComponent"));
@@ -49,6 +54,7 @@ ARPGArcaneMissile::ARPGArcaneMissile()
 void ARPGArcaneMissile::BeginPlay()
 {
 	Super::BeginPlay();
+	RPGStats::RecordProjectileSpawned();
 	
 	// Set lifespan
 	SetLifeSpan(ProjectileLifespan);
@@ -58,10 +64,48 @@ void ARPGArcaneMissile::BeginPlay()
 	{
 		HomingTarget = FindNearestTarget();
 	}
+
+	if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(this))
+	{
+		BatchedTick->GetMissileHoming().Register(this);
+	}
+	else
+	{
+		SetActorTickEnabled(true);
+		INC_DWORD_STAT(STAT_RPG_TickingProjectiles);
+	}
+
+	if (URPGSignificanceSubsystem* Significance = URPGSignificanceSubsystem::Get(this))
+	{
+		Significance->RegisterActor(this, FOnSignificanceTierChanged::CreateUObject(this, &ARPGArcaneMissile::ApplySignificanceTier));
+	}
+}
+
+void ARPGArcaneMissile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	RPGStats::RecordProjectileDestroyed();
+
+	if (URPGSignificanceSubsystem* Significance = URPGSignificanceSubsystem::Get(this))
+	{
+		Significance->UnregisterActor(this);
+	}
+
+	if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(this))
+	{
+		BatchedTick->GetMissileHoming().Unregister(this);
+	}
+	else if (IsActorTickEnabled())
+	{
+		DEC_DWORD_STAT(STAT_RPG_TickingProjectiles);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ARPGArcaneMissile::Tick(float DeltaTime)
 {
+	RPG_BENCHMARK_SCOPE(Projectile);
+
 	Super::Tick(DeltaTime);
 
 	// Update homing behavior
@@ -76,6 +120,9 @@ void ARPGArcaneMissile::InitializeProjectile(AActor* Target, const FRPGGameplayE
 
 void ARPGArcaneMissile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	RPG_BENCHMARK_SCOPE(Projectile);
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_ProjectileHit);
+
 	// Don't hit the instigator
 	if (OtherActor && OtherActor != GetInstigator())
 	{
@@ -110,12 +157,15 @@ void ARPGArcaneMissile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor,
 
 AActor* ARPGArcaneMissile::FindNearestTarget()
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_FindNearestTarget);
+
 	AActor* NearestTarget = nullptr;
 	float NearestDistance = HomingRange;
 
 	// Get all actors of class RPGCharacterBase
 	TArray<AActor*> FoundActors;
 	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ARPGCharacterBase::StaticClass(), FoundActors);
+	RPGStats::RecordTargetSearch(FoundActors.Num());
 
 	for (AActor* Actor : FoundActors)
 	{
@@ -151,40 +201,65 @@ AActor* ARPGArcaneMissile::FindNearestTarget()
 
 void ARPGArcaneMissile::UpdateHoming(float DeltaTime)
 {
-	if (HomingTarget && ProjectileMovement)
+	if (ProjectileMovement)
+	{
+		if (AActor* Target = UpdateHomingTarget())
+		{
+			ProjectileMovement->Velocity = CalculateHomingVelocity(GetActorLocation(), Target->GetActorLocation(), ProjectileMovement->Velocity, ProjectileMovement->MaxSpeed, HomingAcceleration, DeltaTime);
+		}
+	}
+}
+
+AActor* ARPGArcaneMissile::UpdateHomingTarget()
+{
+	if (HomingTarget)
 	{
 		// Check if target is still valid and in range
-		float DistanceToTarget = FVector::Dist(GetActorLocation(), HomingTarget->GetActorLocation());
-		if (DistanceToTarget > HomingRange * 2.0f || !IsValid(HomingTarget))
+		if (!IsValid(HomingTarget) || FVector::Dist(GetActorLocation(), HomingTarget->GetActorLocation()) > HomingRange * 2.0f)
 		{
 			// Target too far or invalid, find new target
 			HomingTarget = FindNearestTarget();
 		}
+	}
 
-		if (HomingTarget)
-		{
-			// Calculate direction to target
-			FVector DirectionToTarget = (HomingTarget->GetActorLocation() - GetActorLocation()).GetSafeNormal();
-			
-			// Apply homing acceleration
-			FVector CurrentVelocity = ProjectileMovement->Velocity;
-			FVector DesiredVelocity = DirectionToTarget * ProjectileMovement->MaxSpeed;
-			FVector AccelerationVector = (DesiredVelocity - CurrentVelocity) * HomingAcceleration * DeltaTime;
-			
-			// Limit acceleration magnitude
-			if (AccelerationVector.Size() > HomingAcceleration * DeltaTime)
-			{
-				AccelerationVector = AccelerationVector.GetSafeNormal() * HomingAcceleration * DeltaTime;
-			}
-			
-			// Apply the acceleration
-			ProjectileMovement->Velocity += AccelerationVector;
-			
-			// Ensure we don't exceed max speed
-			if (ProjectileMovement->Velocity.Size() > ProjectileMovement->MaxSpeed)
-			{
-				ProjectileMovement->Velocity = ProjectileMovement->Velocity.GetSafeNormal() * ProjectileMovement->MaxSpeed;
-			}
-		}
+	return HomingTarget;
+}
+
+FVector ARPGArcaneMissile::CalculateHomingVelocity(const FVector& Location, const FVector& TargetLocation, const FVector& Velocity, float MaxSpeed, float HomingAcceleration, float DeltaTime)
+{
+	// Calculate direction to target
+	const FVector DirectionToTarget = (TargetLocation - Location).GetSafeNormal();
+
+	// Apply homing acceleration
+	const FVector DesiredVelocity = DirectionToTarget * MaxSpeed;
+	FVector AccelerationVector = (DesiredVelocity - Velocity) * HomingAcceleration * DeltaTime;
+
+	// Limit acceleration magnitude
+	if (AccelerationVector.Size() > HomingAcceleration * DeltaTime)
+	{
+		AccelerationVector = AccelerationVector.GetSafeNormal() * HomingAcceleration * DeltaTime;
+	}
+
+	// Apply the acceleration, ensuring we don't exceed max speed
+	FVector NewVelocity = Velocity + AccelerationVector;
+	if (NewVelocity.Size() > MaxSpeed)
+	{
+		NewVelocity = NewVelocity.GetSafeNormal() * MaxSpeed;
+	}
+
+	return NewVelocity;
+}
+
+void ARPGArcaneMissile::ApplySignificanceTier(ERPGSignificanceTier Tier)
+{
+	// Homing scales by DeltaTime, so a longer interval turns in fewer, larger steps
+	const float TickInterval = URPGSignificanceSubsystem::Get(this)->GetTierSettings(Tier).ProjectileTickInterval;
+	if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(this))
+	{
+		BatchedTick->GetMissileHoming().SetTickInterval(this, TickInterval);
+	}
+	else
+	{
+		SetActorTickInterval(TickInterval);
 	}
 }
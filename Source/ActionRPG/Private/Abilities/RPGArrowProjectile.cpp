@@ -1,6 +1,8 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Abilities/RPGArrowProjectile.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
 #include "RPGCharacterBase.h"
 #include "Abilities/RPGAbilitySystemComponent.h"
 #include "Components/SphereComponent.h"
@@ -47,11 +49,18 @@ ARPGArrowProjectile::ARPGArrowProjectile()
 void ARPGArrowProjectile::BeginPlay()
 {
 	Super::BeginPlay();
+	RPGStats::RecordProjectileSpawned();
 	
 	// Set lifespan
 	SetLifeSpan(ProjectileLifespan);
 }
 
+void ARPGArrowProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	RPGStats::RecordProjectileDestroyed();
+	Super::EndPlay(EndPlayReason);
+}
+
 void ARPGArrowProjectile::InitializeArrow(AActor* Target, float Damage)
 {
 	TargetActor = Target;
@@ -60,6 +69,9 @@ void ARPGArrowProjectile::InitializeArrow(AActor* Target, float Damage)
 
 void ARPGArrowProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	RPG_BENCHMARK_SCOPE(Projectile);
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_ProjectileHit);
+
 	// Don't hit the instigator
 	if (OtherActor && OtherActor != GetInstigator())
 	{
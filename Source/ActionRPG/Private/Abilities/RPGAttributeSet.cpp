@@ -1,6 +1,8 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Abilities/RPGAttributeSet.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
 #include "Abilities/RPGAbilitySystemComponent.h"
 #include "RPGCharacterBase.h"
 #include "GameplayEffect.h"
@@ -111,10 +113,11 @@ void URPGAttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute, f
 
 void URPGAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
 {
+	RPG_BENCHMARK_SCOPE(AttributeCallback);
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_PostGameplayEffectExecute);
+
 	Super::PostGameplayEffectExecute(Data);
 
-	FGameplayEffectContextHandle Context = Data.EffectSpec.GetContext();
-	UAbilitySystemComponent* Source = Context.GetOriginalInstigatorAbilitySystemComponent();
 	const FGameplayTagContainer& SourceTags = *Data.EffectSpec.CapturedSourceTags.GetAggregatedTags();
 
 	// Compute the delta between old and new, if it is available
@@ -125,59 +128,15 @@ void URPGAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbac
 		DeltaValue = Data.EvaluatedData.Magnitude;
 	}
 
-	// Get the Target actor, which should be our owner
-	AActor* TargetActor = nullptr;
-	AController* TargetController = nullptr;
+	// Get the Target character, which should be our owner
 	ARPGCharacterBase* TargetCharacter = nullptr;
 	if (Data.Target.AbilityActorInfo.IsValid() && Data.Target.AbilityActorInfo->AvatarActor.IsValid())
 	{
-		TargetActor = Data.Target.AbilityActorInfo->AvatarActor.Get();
-		TargetController = Data.Target.AbilityActorInfo->PlayerController.Get();
-		TargetCharacter = Cast<ARPGCharacterBase>(TargetActor);
+		TargetCharacter = Cast<ARPGCharacterBase>(Data.Target.AbilityActorInfo->AvatarActor.Get());
 	}
 
 	if (Data.EvaluatedData.Attribute == GetDamageAttribute())
 	{
-		// Get the Source actor
-		AActor* SourceActor = nullptr;
-		AController* SourceController = nullptr;
-		ARPGCharacterBase* SourceCharacter = nullptr;
-		if (Source && Source->AbilityActorInfo.IsValid() && Source->AbilityActorInfo->AvatarActor.IsValid())
-		{
-			SourceActor = Source->AbilityActorInfo->AvatarActor.Get();
-			SourceController = Source->AbilityActorInfo->PlayerController.Get();
-			if (SourceController == nullptr && SourceActor != nullptr)
-			{
-				if (APawn* Pawn = Cast<APawn>(SourceActor))
-				{
-					SourceController = Pawn->GetController();
-				}
-			}
-
-			// Use the controller to find the source pawn
-			if (SourceController)
-			{
-				SourceCharacter = Cast<ARPGCharacterBase>(SourceController->GetPawn());
-			}
-			else
-			{
-				SourceCharacter = Cast<ARPGCharacterBase>(SourceActor);
-			}
-
-			// Set the causer actor based on context if it's set
-			if (Context.GetEffectCauser())
-			{
-				SourceActor = Context.GetEffectCauser();
-			}
-		}
-
-		// Try to extract a hit result
-		FHitResult HitResult;
-		if (Context.GetHitResult())
-		{
-			HitResult = *Context.GetHitResult();
-		}
-
 		// Store a local copy of the amount of damage done and clear the damage attribute
 		const float LocalDamageDone = GetDamage();
 		SetDamage(0.f);
@@ -190,8 +149,55 @@ void URPGAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbac
 
 			if (TargetCharacter)
 			{
-				// This is proper damage
-				TargetCharacter->HandleDamage(LocalDamageDone, HitResult, SourceTags, SourceCharacter, SourceActor);
+				// Resolving the source is only worth it if someone wants per-hit damage info
+				if (TargetCharacter->WantsDamageNotifies())
+				{
+					FGameplayEffectContextHandle Context = Data.EffectSpec.GetContext();
+					UAbilitySystemComponent* Source = Context.GetOriginalInstigatorAbilitySystemComponent();
+
+					// Get the Source actor
+					AActor* SourceActor = nullptr;
+					AController* SourceController = nullptr;
+					ARPGCharacterBase* SourceCharacter = nullptr;
+					if (Source && Source->AbilityActorInfo.IsValid() && Source->AbilityActorInfo->AvatarActor.IsValid())
+					{
+						SourceActor = Source->AbilityActorInfo->AvatarActor.Get();
+						SourceController = Source->AbilityActorInfo->PlayerController.Get();
+						if (SourceController == nullptr && SourceActor != nullptr)
+						{
+							if (APawn* Pawn = Cast<APawn>(SourceActor))
+							{
+								SourceController = Pawn->GetController();
+							}
+						}
+
+						// Use the controller to find the source pawn
+						if (SourceController)
+						{
+							SourceCharacter = Cast<ARPGCharacterBase>(SourceController->GetPawn());
+						}
+						else
+						{
+							SourceCharacter = Cast<ARPGCharacterBase>(SourceActor);
+						}
+
+						// Set the causer actor based on context if it's set
+						if (Context.GetEffectCauser())
+						{
+							SourceActor = Context.GetEffectCauser();
+						}
+					}
+
+					// Try to extract a hit result
+					FHitResult HitResult;
+					if (Context.GetHitResult())
+					{
+						HitResult = *Context.GetHitResult();
+					}
+
+					// This is proper damage
+					TargetCharacter->HandleDamage(LocalDamageDone, HitResult, SourceTags, SourceCharacter, SourceActor);
+				}
 
 				// Call for all health changes
 				TargetCharacter->HandleHealthChanged(-LocalDamageDone, SourceTags);
@@ -0,0 +1,137 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Abilities/RPGAutoFireAbility.h"
+#include "RPGCharacterBase.h"
+#include "TimerManager.h"
+
+URPGAutoFireAbility::URPGAutoFireAbility()
+{
+	// Auto fire needs a persistent instance to hold the cached target and timer
+	InstancingPolicy = EGameplayAbilityInstancingPolicy::InstancedPerActor;
+	bAutoFire = false;
+	FireInterval = 0.25f;
+	TargetRefreshInterval = 0.5f;
+	MaxBurstShots = 0;
+	LastTargetSearchTime = 0.0;
+	BurstShotCount = 0;
+}
+
+void URPGAutoFireAbility::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
+{
+	if (!CommitAbility(Handle, ActorInfo, ActivationInfo))
+	{
+		EndAbility(Handle, ActorInfo, ActivationInfo, true, true);
+		return;
+	}
+
+	if (!bAutoFire)
+	{
+		// Single shot, end immediately as the projectile handles the rest
+		FireShot(FindShotTarget());
+		EndAbility(Handle, ActorInfo, ActivationInfo, false, false);
+		return;
+	}
+
+	BurstShotCount = 0;
+	CachedTarget.Reset();
+
+	// Only the authority runs the shot loop. Clients pay for one activation and one end per burst,
+	// and the projectiles spawned on the server reach them through actor replication on the next net update
+	if (!ActorInfo->IsNetAuthority())
+	{
+		return;
+	}
+
+	FireAutoShot();
+
+	if (IsActive())
+	{
+		GetWorld()->GetTimerManager().SetTimer(FireTimerHandle, this, &URPGAutoFireAbility::HandleFireTimer, FireInterval, true);
+	}
+}
+
+void URPGAutoFireAbility::InputReleased(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo)
+{
+	Super::InputReleased(Handle, ActorInfo, ActivationInfo);
+
+	StopFiring();
+}
+
+void URPGAutoFireAbility::EndAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateEndAbility, bool bWasCancelled)
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(FireTimerHandle);
+	}
+	CachedTarget.Reset();
+
+	Super::EndAbility(Handle, ActorInfo, ActivationInfo, bReplicateEndAbility, bWasCancelled);
+}
+
+void URPGAutoFireAbility::StopFiring()
+{
+	if (IsActive())
+	{
+		EndAbility(CurrentSpecHandle, CurrentActorInfo, CurrentActivationInfo, true, false);
+	}
+}
+
+bool URPGAutoFireAbility::IsAutoFiring() const
+{
+	return bAutoFire && IsActive();
+}
+
+void URPGAutoFireAbility::FireShot(AActor* Target)
+{
+	// Subclasses spawn their projectile here
+}
+
+AActor* URPGAutoFireAbility::FindShotTarget()
+{
+	return nullptr;
+}
+
+bool URPGAutoFireAbility::IsShotTargetValid(AActor* Target) const
+{
+	const ARPGCharacterBase* TargetCharacter = Cast<ARPGCharacterBase>(Target);
+	return TargetCharacter && TargetCharacter->GetHealth() > 0.0f;
+}
+
+void URPGAutoFireAbility::HandleFireTimer()
+{
+	if (!IsActive())
+	{
+		return;
+	}
+
+	// The first shot was paid for by the activation commit, cooldown is only committed there
+	if (!CommitAbilityCost(CurrentSpecHandle, CurrentActorInfo, CurrentActivationInfo))
+	{
+		StopFiring();
+		return;
+	}
+
+	FireAutoShot();
+}
+
+void URPGAutoFireAbility::FireAutoShot()
+{
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+
+	AActor* Target = CachedTarget.Get();
+	if (!Target || !IsShotTargetValid(Target) || WorldTime - LastTargetSearchTime >= TargetRefreshInterval)
+	{
+		Target = FindShotTarget();
+		CachedTarget = Target;
+		LastTargetSearchTime = WorldTime;
+	}
+
+	FireShot(Target);
+
+	BurstShotCount++;
+
+	if (MaxBurstShots > 0 && BurstShotCount >= MaxBurstShots)
+	{
+		StopFiring();
+	}
+}
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Abilities/RPGDamageExecution.h"
+#include "RPGBenchmark.h"
 #include "Abilities/RPGAttributeSet.h"
 #include "AbilitySystemComponent.h"
 
@@ -40,6 +41,8 @@ URPGDamageExecution::URPGDamageExecution()
 
 void URPGDamageExecution::Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, OUT FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const
 {
+	RPG_BENCHMARK_SCOPE(GameplayEffectExecute);
+
 	UAbilitySystemComponent* TargetAbilitySystemComponent = ExecutionParams.GetTargetAbilitySystemComponent();
 	UAbilitySystemComponent* SourceAbilitySystemComponent = ExecutionParams.GetSourceAbilitySystemComponent();
 
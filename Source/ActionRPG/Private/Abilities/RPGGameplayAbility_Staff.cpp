@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Abilities/RPGGameplayAbility_Staff.h"
+#include "RPGStats.h"
 #include "RPGHomingProjectile.h"
 #include "RPGCharacterBase.h"
 #include "Kismet/GameplayStatics.h"
@@ -9,28 +10,28 @@
 
 URPGGameplayAbility_Staff::URPGGameplayAbility_Staff()
 {
-	InstancingPolicy = EGameplayAbilityInstancingPolicy::InstancedPerActor;
 	TargetSearchRange = 2000.0f;
 	BaseDamage = 25.0f;
 	SpawnOffset = FVector(50.0f, 0.0f, 50.0f);
 }
 
-void URPGGameplayAbility_Staff::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
+void URPGGameplayAbility_Staff::SpawnHomingProjectile()
 {
-	if (!CommitAbility(Handle, ActorInfo, ActivationInfo))
-	{
-		EndAbility(Handle, ActorInfo, ActivationInfo, true, true);
-		return;
-	}
+	FireShot(FindBestTarget());
+}
 
-	// Spawn the projectile
-	SpawnHomingProjectile();
+AActor* URPGGameplayAbility_Staff::FindShotTarget()
+{
+	return FindBestTarget();
+}
 
-	// End ability immediately as projectile handles the rest
-	EndAbility(Handle, ActorInfo, ActivationInfo, false, false);
+bool URPGGameplayAbility_Staff::IsShotTargetValid(AActor* Target) const
+{
+	const AActor* Avatar = GetAvatarActorFromActorInfo();
+	return Super::IsShotTargetValid(Target) && Avatar && FVector::DistSquared(Avatar->GetActorLocation(), Target->GetActorLocation()) <= FMath::Square(TargetSearchRange);
 }
 
-void URPGGameplayAbility_Staff::SpawnHomingProjectile()
+void URPGGameplayAbility_Staff::FireShot(AActor* Target)
 {
 	if (!ProjectileClass)
 	{
@@ -49,9 +50,6 @@ void URPGGameplayAbility_Staff::SpawnHomingProjectile()
 		return;
 	}
 
-	// Find target
-	AActor* Target = FindBestTarget();
-
 	// Calculate spawn location
 	FVector SpawnLocation = Character->GetActorLocation();
 	FRotator SpawnRotation = Character->GetActorRotation();
@@ -92,6 +90,8 @@ void URPGGameplayAbility_Staff::SpawnHomingProjectile()
 
 AActor* URPGGameplayAbility_Staff::FindBestTarget()
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_FindNearestTarget);
+
 	ACharacter* Character = Cast<ACharacter>(GetAvatarActorFromActorInfo());
 	if (!Character)
 	{
@@ -118,6 +118,7 @@ AActor* URPGGameplayAbility_Staff::FindBestTarget()
 		FCollisionShape::MakeSphere(TargetSearchRange),
 		QueryParams
 	);
+	RPGStats::RecordTargetSearch(OverlapResults.Num());
 
 	if (!bFoundTargets)
 	{
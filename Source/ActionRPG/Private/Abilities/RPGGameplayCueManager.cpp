@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Abilities/RPGGameplayCueManager.h"
+#include "GameplayCueSet.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "RPGBootProfile.h"
+
+void URPGGameplayCueManager::OnCreated()
+{
+	Super::OnCreated();
+
+	if (RPGBoot::IsFastBoot())
+	{
+		TWeakObjectPtr<URPGGameplayCueManager> WeakThis(this);
+		RPGBoot::DeferUntilFirstFrame([WeakThis]()
+		{
+			if (URPGGameplayCueManager* CueManager = WeakThis.Get())
+			{
+				CueManager->LoadDeferredCueNotifies();
+			}
+		});
+	}
+}
+
+bool URPGGameplayCueManager::ShouldAsyncLoadRuntimeObjectLibraries() const
+{
+	// The scan still happens so cues can be found, only the loads wait
+	return !RPGBoot::IsFastBoot() && Super::ShouldAsyncLoadRuntimeObjectLibraries();
+}
+
+void URPGGameplayCueManager::LoadDeferredCueNotifies()
+{
+	UGameplayCueSet* CueSet = GetRuntimeCueSet();
+	if (!CueSet)
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> CueNotifyPaths;
+	for (const FGameplayCueNotifyData& CueData : CueSet->GameplayCueData)
+	{
+		if (!CueData.LoadedGameplayCueClass && CueData.GameplayCueNotifyObj.IsValid())
+		{
+			CueNotifyPaths.Add(CueData.GameplayCueNotifyObj);
+		}
+	}
+
+	if (CueNotifyPaths.Num() == 0)
+	{
+		return;
+	}
+
+	UE_LOG(LogActionRPG, Log, TEXT("Loading %d gameplay cue notifies deferred by fast boot"), CueNotifyPaths.Num());
+
+	// Cue sets pick up loaded classes the first time the cue is handled
+	DeferredCueNotifyHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(CueNotifyPaths, FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority, false, false, TEXT("DeferredGameplayCues"));
+}
@@ -0,0 +1,9 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Abilities/RPGLevelMagnitudeCalculation.h"
+#include "RPGAssetManager.h"
+
+float URPGLevelMagnitudeCalculation::CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const
+{
+	return URPGAssetManager::Get().GetScalableFloatAtLevel(Magnitude, FMath::RoundToInt(Spec.GetLevel()));
+}
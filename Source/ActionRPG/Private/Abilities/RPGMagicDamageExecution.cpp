@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Abilities/RPGMagicDamageExecution.h"
+#include "RPGBenchmark.h"
 #include "Abilities/RPGAttributeSet.h"
 #include "AbilitySystemComponent.h"
 
@@ -38,6 +39,8 @@ URPGMagicDamageExecution::URPGMagicDamageExecution()
 
 void URPGMagicDamageExecution::Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, OUT FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const
 {
+	RPG_BENCHMARK_SCOPE(GameplayEffectExecute);
+
 	UAbilitySystemComponent* TargetAbilitySystemComponent = ExecutionParams.GetTargetAbilitySystemComponent();
 	UAbilitySystemComponent* SourceAbilitySystemComponent = ExecutionParams.GetSourceAbilitySystemComponent();
 
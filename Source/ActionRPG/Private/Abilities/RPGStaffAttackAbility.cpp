@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Abilities/RPGStaffAttackAbility.h"
+#include "RPGStats.h"
 #include "Abilities/RPGArcaneMissile.h"
 #include "Items/RPGStaffItem.h"
 #include "RPGCharacterBase.h"
@@ -24,22 +25,23 @@ URPGStaffAttackAbility::URPGStaffAttackAbility()
 	// CooldownTags.AddTag(FGameplayTag::RequestGameplayTag(FName("Cooldown.Skill")));
 }
 
-void URPGStaffAttackAbility::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
+void URPGStaffAttackAbility::FireArcaneMissile()
 {
-	if (!CommitAbility(Handle, ActorInfo, ActivationInfo))
-	{
-		EndAbility(Handle, ActorInfo, ActivationInfo, true, true);
-		return;
-	}
+	FireShot(FindTarget());
+}
 
-	// Fire the arcane missile
-	FireArcaneMissile();
+AActor* URPGStaffAttackAbility::FindShotTarget()
+{
+	return FindTarget();
+}
 
-	// End ability immediately (instant cast)
-	EndAbility(Handle, ActorInfo, ActivationInfo, false, false);
+bool URPGStaffAttackAbility::IsShotTargetValid(AActor* Target) const
+{
+	const AActor* Avatar = GetAvatarActorFromActorInfo();
+	return Super::IsShotTargetValid(Target) && Avatar && FVector::DistSquared(Avatar->GetActorLocation(), Target->GetActorLocation()) <= FMath::Square(TargetingRange);
 }
 
-void URPGStaffAttackAbility::FireArcaneMissile()
+void URPGStaffAttackAbility::FireShot(AActor* Target)
 {
 	if (!ProjectileClass)
 	{
@@ -60,9 +62,6 @@ void URPGStaffAttackAbility::FireArcaneMissile()
 	// Calculate spawn rotation (forward direction)
 	FRotator SpawnRotation = Character->GetActorRotation();
 
-	// Find target
-	AActor* Target = FindTarget();
-
 	// Spawn parameters
 	FActorSpawnParameters SpawnParams;
 	SpawnParams.Owner = Character;
@@ -72,20 +71,19 @@ void URPGStaffAttackAbility::FireArcaneMissile()
 	// Spawn the projectile
 	if (ARPGArcaneMissile* Missile = GetWorld()->SpawnActor<ARPGArcaneMissile>(ProjectileClass, SpawnLocation, SpawnRotation, SpawnParams))
 	{
-		// Create effect container for magic damage
-		FRPGGameplayEffectContainer EffectContainer;
-		if (EffectContainerMap.Contains(FGameplayTag::RequestGameplayTag(FName("Event.Montage.Shared.MagicHit"))))
-		{
-			EffectContainer = EffectContainerMap[FGameplayTag::RequestGameplayTag(FName("Event.Montage.Shared.MagicHit"))];
-		}
+		// Create effect container for magic damage, the tag is resolved once instead of per shot
+		static const FGameplayTag MagicHitTag = FGameplayTag::RequestGameplayTag(FName("Event.Montage.Shared.MagicHit"));
+		const FRPGGameplayEffectContainer* EffectContainer = EffectContainerMap.Find(MagicHitTag);
 
 		// Initialize the missile
-		Missile->InitializeProjectile(Target, EffectContainer);
+		Missile->InitializeProjectile(Target, EffectContainer ? *EffectContainer : FRPGGameplayEffectContainer());
 	}
 }
 
 AActor* URPGStaffAttackAbility::FindTarget()
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_FindNearestTarget);
+
 	ARPGCharacterBase* Character = Cast<ARPGCharacterBase>(GetAvatarActorFromActorInfo());
 	if (!Character)
 	{
@@ -98,6 +96,7 @@ AActor* URPGStaffAttackAbility::FindTarget()
 	// Get all actors of class RPGCharacterBase
 	TArray<AActor*> FoundActors;
 	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ARPGCharacterBase::StaticClass(), FoundActors);
+	RPGStats::RecordTargetSearch(FoundActors.Num());
 
 	for (AActor* Actor : FoundActors)
 	{
@@ -1,8 +1,35 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ActionRPG.h"
+#include "RPGBootProfile.h"
+#include "RPGCharacterBase.h"
+#include "SkeletalMeshComponentBudgeted.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ActionRPG, "ActionRPG" );
+/** Game module, only does enough at startup to time the boot and hook up engine callbacks */
+class FActionRPGModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		RPGBoot::MarkEvent(TEXT("GameModuleStartup"));
+
+		PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddStatic(&RPGBoot::NotifyMapLoaded);
+
+		// Every budgeted mesh in the game belongs to a character, so one significance function covers them all
+		USkeletalMeshComponentBudgeted::OnCalculateSignificance().BindStatic(&ARPGCharacterBase::CalculateAnimationSignificance);
+	}
+
+	virtual void ShutdownModule() override
+	{
+		USkeletalMeshComponentBudgeted::OnCalculateSignificance().Unbind();
+		FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	}
+
+private:
+	FDelegateHandle PostLoadMapHandle;
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FActionRPGModule, ActionRPG, "ActionRPG" );
 
 /** Logging definitions */
 DEFINE_LOG_CATEGORY(LogActionRPG);
\ No newline at end of file
@@ -0,0 +1,418 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Commandlets/RPGCombatBenchmarkCommandlet.h"
+#include "RPGBenchmark.h"
+#include "RPGArcherEnemy.h"
+#include "RPGCharacterBase.h"
+#include "RPGPlayerControllerBase.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectArray.h"
+
+namespace RPGCombatBenchmark
+{
+	/** Returns the value at a percentile of an already sorted array */
+	float Percentile(const TArray<float>& SortedSamples, float Percent)
+	{
+		if (SortedSamples.Num() == 0)
+		{
+			return 0.f;
+		}
+
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percent * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+		return SortedSamples[Index];
+	}
+
+	/** Writes total/avg/percentiles/max for a set of per frame millisecond samples */
+	void WriteSampleStats(TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>& Writer, const TArray<float>& Samples)
+	{
+		TArray<float> Sorted = Samples;
+		Sorted.Sort();
+
+		double Total = 0.0;
+		for (float Sample : Sorted)
+		{
+			Total += Sample;
+		}
+
+		Writer.WriteValue(TEXT("total_ms"), Total);
+		Writer.WriteValue(TEXT("avg_ms"), Sorted.Num() > 0 ? Total / Sorted.Num() : 0.0);
+		Writer.WriteValue(TEXT("p50_ms"), Percentile(Sorted, 0.50f));
+		Writer.WriteValue(TEXT("p90_ms"), Percentile(Sorted, 0.90f));
+		Writer.WriteValue(TEXT("p99_ms"), Percentile(Sorted, 0.99f));
+		Writer.WriteValue(TEXT("max_ms"), Sorted.Num() > 0 ? Sorted.Last() : 0.f);
+	}
+
+	/** Returns the closest living character in the list, or null */
+	template<typename CharacterType>
+	CharacterType* FindClosest(const TArray<CharacterType*>& Candidates, const FVector& Origin)
+	{
+		CharacterType* Closest = nullptr;
+		float ClosestDistanceSq = MAX_FLT;
+
+		for (CharacterType* Candidate : Candidates)
+		{
+			if (IsValid(Candidate) && Candidate->GetHealth() > 0.f)
+			{
+				const float DistanceSq = FVector::DistSquared(Origin, Candidate->GetActorLocation());
+				if (DistanceSq < ClosestDistanceSq)
+				{
+					ClosestDistanceSq = DistanceSq;
+					Closest = Candidate;
+				}
+			}
+		}
+		return Closest;
+	}
+}
+
+URPGCombatBenchmarkCommandlet::URPGCombatBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+
+	PlayerAttackInterval = 0.5f;
+	PlayerAttackTimer = 0.f;
+	NumEnemies = 32;
+	NumPlayers = 4;
+	Duration = 30.f;
+	TickRate = 30.f;
+	UsedPhysicalBefore = 0;
+	UsedPhysicalAfter = 0;
+	ObjectCountBefore = 0;
+	ObjectCountAfter = 0;
+}
+
+int32 URPGCombatBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString EnemyClassPath;
+	FString PlayerClassPath;
+	FString AbilityTagList;
+	FString ReportPath = FPaths::ProjectSavedDir() / TEXT("Benchmark") / TEXT("Combat.json");
+	float ArenaRadius = 1500.f;
+
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("Enemies="), NumEnemies);
+	FParse::Value(*Params, TEXT("Players="), NumPlayers);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("TickRate="), TickRate);
+	FParse::Value(*Params, TEXT("ArenaRadius="), ArenaRadius);
+	FParse::Value(*Params, TEXT("AttackInterval="), PlayerAttackInterval);
+	FParse::Value(*Params, TEXT("EnemyClass="), EnemyClassPath);
+	FParse::Value(*Params, TEXT("PlayerClass="), PlayerClassPath);
+	FParse::Value(*Params, TEXT("PlayerAbilityTags="), AbilityTagList, false);
+	FParse::Value(*Params, TEXT("Report="), ReportPath);
+
+	TickRate = FMath::Max(TickRate, 1.f);
+	Duration = FMath::Max(Duration, 0.f);
+
+	// Blueprint classes carry the StateTree, projectile and ability setup, the native classes are only a fallback
+	UClass* EnemyClass = ARPGArcherEnemy::StaticClass();
+	if (!EnemyClassPath.IsEmpty())
+	{
+		UClass* LoadedClass = LoadClass<ARPGArcherEnemy>(nullptr, *EnemyClassPath);
+		if (LoadedClass)
+		{
+			EnemyClass = LoadedClass;
+		}
+		else
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("RPGCombatBenchmark: Failed to load enemy class %s, using native class"), *EnemyClassPath);
+		}
+	}
+
+	UClass* PlayerClass = ARPGCharacterBase::StaticClass();
+	if (!PlayerClassPath.IsEmpty())
+	{
+		UClass* LoadedClass = LoadClass<ARPGCharacterBase>(nullptr, *PlayerClassPath);
+		if (LoadedClass)
+		{
+			PlayerClass = LoadedClass;
+		}
+		else
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("RPGCombatBenchmark: Failed to load player class %s, using native class"), *PlayerClassPath);
+		}
+	}
+
+	TArray<FString> TagNames;
+	AbilityTagList.ParseIntoArray(TagNames, TEXT(","));
+	for (const FString& TagName : TagNames)
+	{
+		FGameplayTag Tag = FGameplayTag::RequestGameplayTag(FName(*TagName.TrimStartAndEnd()), false);
+		if (Tag.IsValid())
+		{
+			PlayerAbilityTags.AddTag(Tag);
+		}
+		else
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("RPGCombatBenchmark: Unknown ability tag %s"), *TagName);
+		}
+	}
+
+	UWorld* World = CreateBenchmarkWorld(MapName);
+	if (!World)
+	{
+		UE_LOG(LogActionRPG, Error, TEXT("RPGCombatBenchmark: Failed to create world"));
+		return 1;
+	}
+
+	SpawnEnemies(World, EnemyClass, NumEnemies, ArenaRadius);
+	SpawnPlayers(World, PlayerClass, NumPlayers);
+
+	const float DeltaSeconds = 1.f / TickRate;
+
+	// Let everything run BeginPlay and settle before measuring
+	for (int32 WarmupFrame = 0; WarmupFrame < 10; WarmupFrame++)
+	{
+		World->Tick(LEVELTICK_All, DeltaSeconds);
+	}
+
+	FDelegateHandle SpawnHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateLambda([this](AActor* SpawnedActor)
+	{
+		SpawnCounts.FindOrAdd(SpawnedActor->GetClass()->GetFName())++;
+	}));
+
+	UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+	ObjectCountBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	const int32 NumFrames = FMath::CeilToInt(Duration * TickRate);
+	TArray<float> FrameTimes;
+	FrameTimes.Reserve(NumFrames);
+
+	FRPGBenchmark::Start();
+
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		const double FrameStart = FPlatformTime::Seconds();
+
+		DriveCombat(DeltaSeconds);
+		World->Tick(LEVELTICK_All, DeltaSeconds);
+
+		FrameTimes.Add((float)((FPlatformTime::Seconds() - FrameStart) * 1000.0));
+		FRPGBenchmark::EndFrame();
+	}
+
+	FRPGBenchmark::Stop();
+
+	UsedPhysicalAfter = FPlatformMemory::GetStats().UsedPhysical;
+	ObjectCountAfter = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	World->RemoveOnActorSpawnedHandler(SpawnHandle);
+
+	const bool bWroteReport = WriteReport(ReportPath, FrameTimes);
+
+	DestroyBenchmarkWorld(World);
+
+	return bWroteReport ? 0 : 1;
+}
+
+UWorld* URPGCombatBenchmarkCommandlet::CreateBenchmarkWorld(const FString& InMapName)
+{
+	UWorld* World = nullptr;
+
+	if (!InMapName.IsEmpty())
+	{
+		UPackage* MapPackage = LoadPackage(nullptr, *InMapName, LOAD_None);
+		World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+
+		if (!World)
+		{
+			UE_LOG(LogActionRPG, Error, TEXT("RPGCombatBenchmark: Failed to load map %s"), *InMapName);
+			return nullptr;
+		}
+
+		World->WorldType = EWorldType::Game;
+		World->AddToRoot();
+		World->InitWorld();
+	}
+	else
+	{
+		// An empty world is enough to measure abilities and projectiles, AI movement needs a map with navigation
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("RPGCombatBenchmark"));
+		World->AddToRoot();
+	}
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	return World;
+}
+
+void URPGCombatBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World)
+{
+	Enemies.Reset();
+	Players.Reset();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void URPGCombatBenchmarkCommandlet::SpawnEnemies(UWorld* World, UClass* EnemyClass, int32 Count, float Radius)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		const float Angle = 2.f * PI * Index / FMath::Max(Count, 1);
+		const FVector Location(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 100.f);
+		const FRotator Rotation = (-Location).Rotation();
+
+		ARPGArcherEnemy* Enemy = World->SpawnActor<ARPGArcherEnemy>(EnemyClass, Location, Rotation, SpawnParams);
+		if (Enemy)
+		{
+			if (!Enemy->GetController())
+			{
+				Enemy->SpawnDefaultController();
+			}
+			Enemies.Add(Enemy);
+		}
+	}
+
+	UE_LOG(LogActionRPG, Display, TEXT("RPGCombatBenchmark: Spawned %d/%d enemies of class %s"), Enemies.Num(), Count, *EnemyClass->GetName());
+}
+
+void URPGCombatBenchmarkCommandlet::SpawnPlayers(UWorld* World, UClass* PlayerClass, int32 Count)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		const FVector Location(Index * 150.f, 0.f, 100.f);
+
+		ARPGCharacterBase* Player = World->SpawnActor<ARPGCharacterBase>(PlayerClass, Location, FRotator::ZeroRotator, SpawnParams);
+		if (Player)
+		{
+			// A player controller makes the pawn a valid target for the archer AI and grants startup abilities on possess
+			ARPGPlayerControllerBase* Controller = World->SpawnActor<ARPGPlayerControllerBase>(ARPGPlayerControllerBase::StaticClass(), Location, FRotator::ZeroRotator);
+			if (Controller)
+			{
+				Controller->Possess(Player);
+			}
+			Players.Add(Player);
+		}
+	}
+
+	UE_LOG(LogActionRPG, Display, TEXT("RPGCombatBenchmark: Spawned %d/%d players of class %s"), Players.Num(), Count, *PlayerClass->GetName());
+}
+
+void URPGCombatBenchmarkCommandlet::DriveCombat(float DeltaSeconds)
+{
+	// Archers fire whenever their cooldown allows, in addition to whatever their StateTree does
+	for (ARPGArcherEnemy* Enemy : Enemies)
+	{
+		if (IsValid(Enemy) && Enemy->GetHealth() > 0.f)
+		{
+			ARPGCharacterBase* Target = RPGCombatBenchmark::FindClosest(Players, Enemy->GetActorLocation());
+			if (Target && Enemy->CanAttackTarget(Target))
+			{
+				Enemy->FireProjectileAtTarget(Target);
+			}
+		}
+	}
+
+	PlayerAttackTimer -= DeltaSeconds;
+	const bool bPlayersAttack = PlayerAttackTimer <= 0.f;
+	if (bPlayersAttack)
+	{
+		PlayerAttackTimer += PlayerAttackInterval;
+	}
+
+	for (ARPGCharacterBase* Player : Players)
+	{
+		if (!IsValid(Player) || Player->GetHealth() <= 0.f)
+		{
+			continue;
+		}
+
+		ARPGArcherEnemy* Target = RPGCombatBenchmark::FindClosest(Enemies, Player->GetActorLocation());
+		if (Target)
+		{
+			// Face the target so melee traces and forward fired missiles connect
+			const FVector ToTarget = Target->GetActorLocation() - Player->GetActorLocation();
+			Player->SetActorRotation(FRotator(0.f, ToTarget.Rotation().Yaw, 0.f));
+
+			if (bPlayersAttack && PlayerAbilityTags.Num() > 0)
+			{
+				Player->ActivateAbilitiesWithTags(PlayerAbilityTags, true);
+			}
+		}
+	}
+}
+
+bool URPGCombatBenchmarkCommandlet::WriteReport(const FString& ReportPath, const TArray<float>& FrameTimes) const
+{
+	FString Json;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+
+	Writer->WriteObjectStart();
+
+	Writer->WriteObjectStart(TEXT("config"));
+	Writer->WriteValue(TEXT("map"), MapName);
+	Writer->WriteValue(TEXT("enemies"), NumEnemies);
+	Writer->WriteValue(TEXT("players"), NumPlayers);
+	Writer->WriteValue(TEXT("duration_s"), Duration);
+	Writer->WriteValue(TEXT("tick_rate"), TickRate);
+	Writer->WriteValue(TEXT("build"), LexToString(FApp::GetBuildConfiguration()));
+	Writer->WriteValue(TEXT("platform"), FPlatformProperties::IniPlatformName());
+	Writer->WriteObjectEnd();
+
+	Writer->WriteValue(TEXT("frames"), FrameTimes.Num());
+
+	Writer->WriteObjectStart(TEXT("frame"));
+	RPGCombatBenchmark::WriteSampleStats(*Writer, FrameTimes);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("subsystems"));
+	for (int32 Index = 0; Index < (int32)ERPGBenchmarkBucket::Num; Index++)
+	{
+		const ERPGBenchmarkBucket Bucket = (ERPGBenchmarkBucket)Index;
+
+		Writer->WriteObjectStart(FRPGBenchmark::GetBucketName(Bucket));
+		Writer->WriteValue(TEXT("calls"), FRPGBenchmark::GetCallCount(Bucket));
+		RPGCombatBenchmark::WriteSampleStats(*Writer, FRPGBenchmark::GetFrameSamples(Bucket));
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectStart(TEXT("allocations"));
+	Writer->WriteValue(TEXT("used_physical_delta_bytes"), (int64)UsedPhysicalAfter - (int64)UsedPhysicalBefore);
+	Writer->WriteValue(TEXT("uobject_delta"), ObjectCountAfter - ObjectCountBefore);
+	Writer->WriteObjectStart(TEXT("spawned_actors"));
+	for (const TPair<FName, int32>& Pair : SpawnCounts)
+	{
+		Writer->WriteValue(Pair.Key.ToString(), Pair.Value);
+	}
+	Writer->WriteObjectEnd();
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(Json, *ReportPath))
+	{
+		UE_LOG(LogActionRPG, Error, TEXT("RPGCombatBenchmark: Failed to write report to %s"), *ReportPath);
+		return false;
+	}
+
+	UE_LOG(LogActionRPG, Display, TEXT("RPGCombatBenchmark: Wrote report for %d frames to %s"), FrameTimes.Num(), *ReportPath);
+	return true;
+}
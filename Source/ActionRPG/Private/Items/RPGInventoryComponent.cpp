@@ -0,0 +1,243 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Items/RPGInventoryComponent.h"
+#include "Items/RPGItem.h"
+#include "RPGAssetManager.h"
+#include "RPGPlayerControllerBase.h"
+
+void FRPGReplicatedItemEntry::PreReplicatedRemove(const FRPGReplicatedItemList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleItemReplicated(*this, true);
+	}
+}
+
+void FRPGReplicatedItemEntry::PostReplicatedAdd(const FRPGReplicatedItemList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleItemReplicated(*this, false);
+	}
+}
+
+void FRPGReplicatedItemEntry::PostReplicatedChange(const FRPGReplicatedItemList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleItemReplicated(*this, false);
+	}
+}
+
+void FRPGReplicatedSlotEntry::PostReplicatedAdd(const FRPGReplicatedSlotList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleSlotReplicated(*this);
+	}
+}
+
+void FRPGReplicatedSlotEntry::PostReplicatedChange(const FRPGReplicatedSlotList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleSlotReplicated(*this);
+	}
+}
+
+URPGInventoryComponent::URPGInventoryComponent()
+{
+	SetIsReplicatedByDefault(true);
+
+	ReplicatedItems.Owner = this;
+	ReplicatedSlots.Owner = this;
+}
+
+void URPGInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Inventory is private to the player
+	DOREPLIFETIME_CONDITION(URPGInventoryComponent, ReplicatedItems, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(URPGInventoryComponent, ReplicatedSlots, COND_OwnerOnly);
+}
+
+void URPGInventoryComponent::SetReplicatedItem(URPGItem* Item, const FRPGItemData& ItemData)
+{
+	if (!Item)
+	{
+		return;
+	}
+
+	const FPrimaryAssetId ItemId = Item->GetPrimaryAssetId();
+	const int32* EntryIndex = ItemEntryIndices.Find(ItemId);
+
+	if (!ItemData.IsValid())
+	{
+		RemoveReplicatedItem(ItemId);
+		return;
+	}
+
+	if (EntryIndex)
+	{
+		FRPGReplicatedItemEntry& Entry = ReplicatedItems.Entries[*EntryIndex];
+		if (Entry.ItemData != ItemData)
+		{
+			Entry.ItemData = ItemData;
+			ReplicatedItems.MarkItemDirty(Entry);
+		}
+		return;
+	}
+
+	ItemEntryIndices.Add(ItemId, ReplicatedItems.Entries.Num());
+
+	FRPGReplicatedItemEntry& NewEntry = ReplicatedItems.Entries.AddDefaulted_GetRef();
+	NewEntry.ItemId = ItemId;
+	NewEntry.ItemData = ItemData;
+	ReplicatedItems.MarkItemDirty(NewEntry);
+}
+
+void URPGInventoryComponent::RemoveReplicatedItem(const FPrimaryAssetId& ItemId)
+{
+	int32 RemovedIndex = INDEX_NONE;
+	if (!ItemEntryIndices.RemoveAndCopyValue(ItemId, RemovedIndex))
+	{
+		return;
+	}
+
+	ReplicatedItems.Entries.RemoveAtSwap(RemovedIndex, 1, EAllowShrinking::No);
+	if (ReplicatedItems.Entries.IsValidIndex(RemovedIndex))
+	{
+		// The last entry moved into the hole
+		ItemEntryIndices.Add(ReplicatedItems.Entries[RemovedIndex].ItemId, RemovedIndex);
+	}
+	ReplicatedItems.MarkArrayDirty();
+}
+
+const FRPGReplicatedItemEntry* URPGInventoryComponent::FindReplicatedItem(const FPrimaryAssetId& ItemId) const
+{
+	const int32* EntryIndex = ItemEntryIndices.Find(ItemId);
+	return EntryIndex ? &ReplicatedItems.Entries[*EntryIndex] : nullptr;
+}
+
+void URPGInventoryComponent::SetReplicatedSlot(const FRPGItemSlot& ItemSlot, URPGItem* Item)
+{
+	const FPrimaryAssetId ItemId = Item ? Item->GetPrimaryAssetId() : FPrimaryAssetId();
+
+	for (FRPGReplicatedSlotEntry& Entry : ReplicatedSlots.Entries)
+	{
+		if (Entry.ItemSlot == ItemSlot)
+		{
+			if (Entry.ItemId != ItemId)
+			{
+				Entry.ItemId = ItemId;
+				ReplicatedSlots.MarkItemDirty(Entry);
+			}
+			return;
+		}
+	}
+
+	// Slots are never removed, an empty slot is sent as an invalid id
+	FRPGReplicatedSlotEntry& NewEntry = ReplicatedSlots.Entries.AddDefaulted_GetRef();
+	NewEntry.ItemSlot = ItemSlot;
+	NewEntry.ItemId = ItemId;
+	ReplicatedSlots.MarkItemDirty(NewEntry);
+}
+
+void URPGInventoryComponent::ClearReplicatedInventory()
+{
+	ItemEntryIndices.Reset();
+
+	if (ReplicatedItems.Entries.Num() > 0)
+	{
+		ReplicatedItems.Entries.Reset();
+		ReplicatedItems.MarkArrayDirty();
+	}
+
+	if (ReplicatedSlots.Entries.Num() > 0)
+	{
+		ReplicatedSlots.Entries.Reset();
+		ReplicatedSlots.MarkArrayDirty();
+	}
+}
+
+void URPGInventoryComponent::SyncReplicatedInventory(const TMap<URPGItem*, FRPGItemData>& InventoryData, const TMap<FRPGItemSlot, URPGItem*>& SlottedItems)
+{
+	TSet<FPrimaryAssetId> ItemIds;
+	ItemIds.Reserve(InventoryData.Num());
+	for (const TPair<URPGItem*, FRPGItemData>& ItemPair : InventoryData)
+	{
+		if (ItemPair.Key)
+		{
+			ItemIds.Add(ItemPair.Key->GetPrimaryAssetId());
+		}
+	}
+
+	// Backwards, so the entries swapped into removed ones have already been checked
+	for (int32 EntryIndex = ReplicatedItems.Entries.Num() - 1; EntryIndex >= 0; EntryIndex--)
+	{
+		if (!ItemIds.Contains(ReplicatedItems.Entries[EntryIndex].ItemId))
+		{
+			RemoveReplicatedItem(ReplicatedItems.Entries[EntryIndex].ItemId);
+		}
+	}
+
+	// Unchanged entries are left alone, so they are not sent again
+	for (const TPair<URPGItem*, FRPGItemData>& ItemPair : InventoryData)
+	{
+		SetReplicatedItem(ItemPair.Key, ItemPair.Value);
+	}
+
+	for (const TPair<FRPGItemSlot, URPGItem*>& SlotPair : SlottedItems)
+	{
+		SetReplicatedSlot(SlotPair.Key, SlotPair.Value);
+	}
+}
+
+void URPGInventoryComponent::ApplyReplicatedInventory()
+{
+	for (const FRPGReplicatedItemEntry& Entry : ReplicatedItems.Entries)
+	{
+		HandleItemReplicated(Entry, false);
+	}
+
+	for (const FRPGReplicatedSlotEntry& Entry : ReplicatedSlots.Entries)
+	{
+		HandleSlotReplicated(Entry);
+	}
+}
+
+void URPGInventoryComponent::HandleItemReplicated(const FRPGReplicatedItemEntry& Entry, bool bRemoved)
+{
+	ARPGPlayerControllerBase* Controller = GetOwningController();
+	URPGItem* Item = ResolveItem(Entry.ItemId);
+
+	if (Controller && Item)
+	{
+		Controller->ApplyReplicatedItem(Item, bRemoved ? FRPGItemData(0, 0) : Entry.ItemData);
+	}
+}
+
+void URPGInventoryComponent::HandleSlotReplicated(const FRPGReplicatedSlotEntry& Entry)
+{
+	ARPGPlayerControllerBase* Controller = GetOwningController();
+
+	if (Controller)
+	{
+		Controller->ApplyReplicatedSlot(Entry.ItemSlot, Entry.ItemId.IsValid() ? ResolveItem(Entry.ItemId) : nullptr);
+	}
+}
+
+URPGItem* URPGInventoryComponent::ResolveItem(const FPrimaryAssetId& ItemId) const
+{
+	URPGAssetManager& AssetManager = URPGAssetManager::Get();
+
+	// Items are normally resident through the item registry, only fall back to a sync load if they are not
+	URPGItem* Item = AssetManager.FindLoadedItem(ItemId);
+	return Item ? Item : AssetManager.ForceLoadItem(ItemId);
+}
+
+ARPGPlayerControllerBase* URPGInventoryComponent::GetOwningController() const
+{
+	return Cast<ARPGPlayerControllerBase>(GetOwner());
+}
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "RPGArcherCharacter.h"
+#include "RPGStats.h"
 #include "Abilities/RPGArrowProjectile.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
@@ -44,12 +45,15 @@ void ARPGArcherCharacter::BeginPlay()
 
 AActor* ARPGArcherCharacter::FindNearestTarget()
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_FindNearestTarget);
+
 	AActor* NearestTarget = nullptr;
 	float NearestDistance = DetectionRange;
 
 	// Get all actors of class RPGCharacterBase
 	TArray<AActor*> FoundActors;
 	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ARPGCharacterBase::StaticClass(), FoundActors);
+	RPGStats::RecordTargetSearch(FoundActors.Num());
 
 	for (AActor* Actor : FoundActors)
 	{
@@ -2,6 +2,7 @@
 
 #include "RPGArcherEnemy.h"
 #include "RPGArcherProjectile.h"
+#include "RPGStats.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/CharacterMovementComponent.h"
 
@@ -15,8 +16,70 @@ ARPGArcherEnemy::ARPGArcherEnemy()
 	RangedDamage = 20.0f;
 	AttackCooldown = 2.0f;
 	
+	ProjectileSocketName = TEXT("hand_r");
+	
 	CurrentTarget = nullptr;
 	LastAttackTime = -999.0f;
+
+	bHasProjectileSocket = false;
+	bProjectileSocketDirty = true;
+}
+
+void ARPGArcherEnemy::BeginPlay()
+{
+	Super::BeginPlay();
+
+	USkeletalMeshComponent* SkelMesh = GetMesh();
+	bHasProjectileSocket = SkelMesh && SkelMesh->DoesSocketExist(ProjectileSocketName);
+	bProjectileSocketDirty = true;
+
+	if (bHasProjectileSocket)
+	{
+		// Budgeted meshes skip animation updates, reading the socket between them would only return the same pose
+		BoneTransformsFinalizedHandle = SkelMesh->RegisterOnBoneTransformsFinalizedDelegate(FOnBoneTransformsFinalizedMultiCast::FDelegate::CreateUObject(this, &ARPGArcherEnemy::HandleBoneTransformsFinalized));
+	}
+}
+
+void ARPGArcherEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (BoneTransformsFinalizedHandle.IsValid())
+	{
+		if (USkeletalMeshComponent* SkelMesh = GetMesh())
+		{
+			SkelMesh->UnregisterOnBoneTransformsFinalizedDelegate(BoneTransformsFinalizedHandle);
+		}
+		BoneTransformsFinalizedHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ARPGArcherEnemy::HandleBoneTransformsFinalized()
+{
+	// Runs for every animation update, most of which never fire, so only note that the socket moved
+	bProjectileSocketDirty = true;
+}
+
+FVector ARPGArcherEnemy::GetProjectileSpawnLocation() const
+{
+	const USkeletalMeshComponent* SkelMesh = GetMesh();
+
+	if (bHasProjectileSocket && SkelMesh)
+	{
+		if (bProjectileSocketDirty)
+		{
+			INC_DWORD_STAT(STAT_RPG_HandSocketRefreshes);
+
+			CachedProjectileSocketTransform = SkelMesh->GetSocketTransform(ProjectileSocketName, RTS_Component);
+			bProjectileSocketDirty = false;
+		}
+
+		// The pose is cached, the component transform follows movement every frame
+		return SkelMesh->GetComponentTransform().TransformPosition(CachedProjectileSocketTransform.GetLocation());
+	}
+
+	// Default offset if no socket
+	return GetActorLocation() + GetActorForwardVector() * 50.0f + GetActorUpVector() * 100.0f;
 }
 
 void ARPGArcherEnemy::FireProjectileAtTarget(AActor* Target)
@@ -40,21 +103,9 @@ void ARPGArcherEnemy::FireProjectileAtTarget(AActor* Target)
 	}
 
 	// Calculate spawn location (from character's hand or weapon socket)
-	FVector SpawnLocation = GetActorLocation();
+	FVector SpawnLocation = GetProjectileSpawnLocation();
 	FRotator SpawnRotation = GetActorRotation();
 
-	// Get socket location if available (e.g., "hand_r" socket)
-	USkeletalMeshComponent* SkelMesh = GetMesh();
-	if (SkelMesh && SkelMesh->DoesSocketExist(FName("hand_r")))
-	{
-		SpawnLocation = SkelMesh->GetSocketLocation(FName("hand_r"));
-	}
-	else
-	{
-		// Default offset if no socket
-		SpawnLocation += GetActorForwardVector() * 50.0f + GetActorUpVector() * 100.0f;
-	}
-
 	// Aim at target
 	FVector TargetLocation = Target->GetActorLocation();
 	
@@ -1,6 +1,8 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "RPGArcherProjectile.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
@@ -46,11 +48,18 @@ ARPGArcherProjectile::ARPGArcherProjectile()
 void ARPGArcherProjectile::BeginPlay()
 {
 	Super::BeginPlay();
+	RPGStats::RecordProjectileSpawned();
 	
 	// Set lifespan
 	SetLifeSpan(ProjectileLifespan);
 }
 
+void ARPGArcherProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	RPGStats::RecordProjectileDestroyed();
+	Super::EndPlay(EndPlayReason);
+}
+
 void ARPGArcherProjectile::InitializeProjectile(float BaseDamage, AActor* DamageInstigator)
 {
 	Damage = BaseDamage;
@@ -59,6 +68,9 @@ void ARPGArcherProjectile::InitializeProjectile(float BaseDamage, AActor* Damage
 
 void ARPGArcherProjectile::OnProjectileHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	RPG_BENCHMARK_SCOPE(Projectile);
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_ProjectileHit);
+
 	// Don't hit ourselves or our instigator
 	if (OtherActor && OtherActor != this && OtherActor != InstigatorActor)
 	{
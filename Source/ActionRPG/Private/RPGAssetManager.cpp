@@ -3,12 +3,99 @@
 #include "RPGAssetManager.h"
 #include "Items/RPGItem.h"
 #include "AbilitySystemGlobals.h"
+#include "ScalableFloat.h"
+#include "Engine/AssetManagerSettings.h"
+#include "Engine/CurveTable.h"
+#include "Engine/StreamableManager.h"
+#include "ActionRPGLoadingScreen.h"
+#include "RPGBootProfile.h"
+#include "HAL/FileManager.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/NameAsStringProxyArchive.h"
 
 const FPrimaryAssetType	URPGAssetManager::PotionItemType = TEXT("Potion");
 const FPrimaryAssetType	URPGAssetManager::SkillItemType = TEXT("Skill");
 const FPrimaryAssetType	URPGAssetManager::TokenItemType = TEXT("Token");
 const FPrimaryAssetType	URPGAssetManager::WeaponItemType = TEXT("Weapon");
 
+/** Loading screen task for the map preload */
+static const FName MapPreloadTaskName(TEXT("MapPreload"));
+
+namespace RPGAssetSnapshot
+{
+	/** 'RPGA', then a version that changes whenever the layout below does */
+	static const uint32 Magic = 0x41475052;
+	static const int32 Version = 2;
+
+	static FString GetSnapshotFilename()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("AssetManager") / TEXT("PrimaryAssetSnapshot.bin");
+	}
+
+	/** Writes or reads the parts of a primary asset's asset data the asset manager uses when registering it */
+	static void SerializeAssetData(FArchive& Ar, FAssetData& AssetData)
+	{
+		FName PackageName = AssetData.PackageName;
+		FName AssetName = AssetData.AssetName;
+		FString AssetClassPath = AssetData.AssetClassPath.ToString();
+		uint32 PackageFlags = AssetData.PackageFlags;
+		TArray<int32> ChunkIds(AssetData.GetChunkIDs());
+		FAssetDataTagMap Tags = AssetData.TagsAndValues.CopyMap();
+		FAssetBundleData BundleData;
+		if (AssetData.TaggedAssetBundles.IsValid())
+		{
+			BundleData = *AssetData.TaggedAssetBundles;
+		}
+
+		Ar << PackageName;
+		Ar << AssetName;
+		Ar << AssetClassPath;
+		Ar << PackageFlags;
+		Ar << ChunkIds;
+
+		int32 NumTags = Tags.Num();
+		Ar << NumTags;
+		if (Ar.IsLoading())
+		{
+			for (int32 TagIndex = 0; TagIndex < NumTags && !Ar.IsError(); TagIndex++)
+			{
+				FName TagName;
+				FString TagValue;
+				Ar << TagName;
+				Ar << TagValue;
+				Tags.Add(TagName, MoveTemp(TagValue));
+			}
+		}
+		else
+		{
+			for (TPair<FName, FString>& Tag : Tags)
+			{
+				Ar << Tag.Key;
+				Ar << Tag.Value;
+			}
+		}
+
+		int32 NumBundles = BundleData.Bundles.Num();
+		Ar << NumBundles;
+		if (NumBundles > 0)
+		{
+			FAssetBundleData::StaticStruct()->SerializeItem(Ar, &BundleData, nullptr);
+		}
+
+		if (Ar.IsLoading() && !Ar.IsError())
+		{
+			AssetData = FAssetData(PackageName, FName(*FPackageName::GetLongPackagePath(PackageName.ToString())), AssetName, FTopLevelAssetPath(AssetClassPath), MoveTemp(Tags), ChunkIds, PackageFlags);
+			if (NumBundles > 0)
+			{
+				AssetData.TaggedAssetBundles = MakeShared<FAssetBundleData, ESPMode::ThreadSafe>(MoveTemp(BundleData));
+			}
+		}
+	}
+}
+
 URPGAssetManager& URPGAssetManager::Get()
 {
 	URPGAssetManager* This = Cast<URPGAssetManager>(GEngine->AssetManager);
@@ -26,14 +113,643 @@ URPGAssetManager& URPGAssetManager::Get()
 
 void URPGAssetManager::StartInitialLoading()
 {
-	Super::StartInitialLoading();
+	{
+		RPG_BOOT_PHASE_SCOPE(TEXT("PrimaryAssetScan"));
+		Super::StartInitialLoading();
+	}
+
+	{
+		RPG_BOOT_PHASE_SCOPE(TEXT("InitGlobalData"));
+		UAbilitySystemGlobals::Get().InitGlobalData();
+	}
+
+	// Lookups fall back to evaluating the curve until the tables are baked
+	RPGBoot::DeferUntilFirstFrame([this]()
+	{
+		RPG_BOOT_PHASE_SCOPE(TEXT("BakeCurveTables"));
+		BakeCurveTables();
+	});
+
+	// In the editor the asset registry may still be scanning, so wait until primary assets are known
+	CallOrRegister_OnCompletedInitialScan(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &URPGAssetManager::HandleInitialScanComplete));
+
+	// Maps that have a manifest start loading their gameplay assets while the loading screen is up
+	FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &URPGAssetManager::HandlePreLoadMap);
+}
+
+void URPGAssetManager::ScanPrimaryAssetTypesFromConfig()
+{
+	bPrimaryAssetSnapshotStale = false;
+
+	if (CanUsePrimaryAssetSnapshot())
+	{
+		{
+			RPG_BOOT_PHASE_SCOPE(TEXT("PrimaryAssetSnapshotKey"));
+			PrimaryAssetSnapshotKey = ComputePrimaryAssetSnapshotKey();
+		}
+
+		bScanningFromSnapshot = ReadPrimaryAssetSnapshot(PrimaryAssetSnapshotKey, PrimaryAssetSnapshot);
+		bPrimaryAssetSnapshotStale = !bScanningFromSnapshot;
+	}
+
+	// Types, rules and everything after the scan are set up from config either way, only the path scans use the snapshot
+	Super::ScanPrimaryAssetTypesFromConfig();
+
+	bScanningFromSnapshot = false;
+	PrimaryAssetSnapshot.Empty();
+}
+
+int32 URPGAssetManager::ScanPathsForPrimaryAssets(FPrimaryAssetType PrimaryAssetType, const TArray<FString>& Paths, UClass* BaseClass, bool bHasBlueprintClasses, bool bIsEditorOnly, bool bForceSynchronousScan)
+{
+	if (!bScanningFromSnapshot)
+	{
+		return Super::ScanPathsForPrimaryAssets(PrimaryAssetType, Paths, BaseClass, bHasBlueprintClasses, bIsEditorOnly, bForceSynchronousScan);
+	}
+
+	// Sets up the type without searching any path, the assets the last full scan found under the paths are added below
+	Super::ScanPathsForPrimaryAssets(PrimaryAssetType, TArray<FString>(), BaseClass, bHasBlueprintClasses, bIsEditorOnly, false);
+
+	int32 NumRegistered = 0;
+	if (const TArray<FAssetData>* Assets = PrimaryAssetSnapshot.Find(PrimaryAssetType))
+	{
+		for (const FAssetData& AssetData : *Assets)
+		{
+			const FPrimaryAssetId AssetId = ExtractPrimaryAssetIdFromData(AssetData, PrimaryAssetType);
+			if (AssetId.IsValid() && RegisterSpecificPrimaryAsset(AssetId, AssetData))
+			{
+				NumRegistered++;
+			}
+		}
+	}
+
+	UE_LOG(LogActionRPG, Verbose, TEXT("Registered %d %s assets from snapshot"), NumRegistered, *PrimaryAssetType.ToString());
+	return NumRegistered;
+}
+
+void URPGAssetManager::HandleInitialScanComplete()
+{
+	if (bPrimaryAssetSnapshotStale)
+	{
+		SavePrimaryAssetSnapshot(PrimaryAssetSnapshotKey);
+		bPrimaryAssetSnapshotStale = false;
+	}
+
+	BuildItemRegistry();
+}
+
+bool URPGAssetManager::CanUsePrimaryAssetSnapshot() const
+{
+	// The editor needs the real scan for cooking and to pick up new assets while it runs
+	if (GIsEditor || IsRunningCommandlet() || FParse::Param(FCommandLine::Get(), TEXT("NoPrimaryAssetSnapshot")))
+	{
+		return false;
+	}
+
+	bool bUseSnapshot = false;
+	GConfig->GetBool(TEXT("/Script/ActionRPG.RPGAssetManager"), TEXT("bUsePrimaryAssetSnapshot"), bUseSnapshot, GGameIni);
+	return bUseSnapshot;
+}
+
+FSHAHash URPGAssetManager::ComputePrimaryAssetSnapshotKey() const
+{
+	FSHA1 Sha;
+
+	auto AddString = [&Sha](const FString& String)
+	{
+		Sha.UpdateWithString(*String, String.Len());
+	};
+
+	AddString(FString::Printf(TEXT("%d"), RPGAssetSnapshot::Version));
+	AddString(FEngineVersion::Current().ToString());
+	AddString(FApp::GetBuildVersion());
+
+	// Any change to what is scanned invalidates the snapshot
+	TArray<FString> TypesToScan;
+	GConfig->GetArray(TEXT("/Script/Engine.AssetManagerSettings"), TEXT("PrimaryAssetTypesToScan"), TypesToScan, GGameIni);
+	for (const FString& TypeToScan : TypesToScan)
+	{
+		AddString(TypeToScan);
+	}
+
+	if (FPlatformProperties::RequiresCookedData())
+	{
+		// Cooked packages are not on disk one by one, but every content change ships a new asset registry
+		const FFileStatData RegistryStat = IFileManager::Get().GetStatData(*(FPaths::ProjectDir() / TEXT("AssetRegistry.bin")));
+		AddString(FString::Printf(TEXT("%lld %lld"), RegistryStat.FileSize, RegistryStat.ModificationTime.GetTicks()));
+	}
+	else
+	{
+		// Packages are saved to a temporary file and moved into place, so adding, removing or saving one changes the timestamp
+		// of its directory. Only the scanned directories are visited, and files are listed without being stat'ed
+		IFileManager& FileManager = IFileManager::Get();
+		TArray<FString> DirectoryStamps;
+		auto AddDirectoryStamp = [&FileManager, &DirectoryStamps](const FString& Directory)
+		{
+			DirectoryStamps.Add(FString::Printf(TEXT("%s %lld"), *Directory, FileManager.GetTimeStamp(*Directory).GetTicks()));
+		};
+
+		for (const FPrimaryAssetTypeInfo& TypeInfo : GetSettings().PrimaryAssetTypesToScan)
+		{
+			for (const FDirectoryPath& Directory : TypeInfo.GetDirectories())
+			{
+				FString DirectoryFilename;
+				if (!FPackageName::TryConvertLongPackageNameToFilename(Directory.Path / TEXT(""), DirectoryFilename))
+				{
+					continue;
+				}
+
+				AddDirectoryStamp(DirectoryFilename);
+				FileManager.IterateDirectoryRecursively(*DirectoryFilename, [&AddDirectoryStamp](const TCHAR* Filename, bool bIsDirectory)
+				{
+					if (bIsDirectory)
+					{
+						AddDirectoryStamp(Filename);
+					}
+					return true;
+				});
+			}
+
+			for (const FSoftObjectPath& SpecificAsset : TypeInfo.GetSpecificAssets())
+			{
+				FString PackageFilename;
+				if (FPackageName::DoesPackageExist(SpecificAsset.GetLongPackageName(), &PackageFilename))
+				{
+					AddDirectoryStamp(PackageFilename);
+				}
+			}
+		}
+
+		// Directory iteration order is not defined
+		DirectoryStamps.Sort();
+		for (const FString& DirectoryStamp : DirectoryStamps)
+		{
+			AddString(DirectoryStamp);
+		}
+	}
+
+	Sha.Final();
+
+	FSHAHash Key;
+	Sha.GetHash(Key.Hash);
+	return Key;
+}
+
+bool URPGAssetManager::ReadPrimaryAssetSnapshot(const FSHAHash& SnapshotKey, TMap<FPrimaryAssetType, TArray<FAssetData>>& OutAssets)
+{
+	OutAssets.Reset();
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *RPGAssetSnapshot::GetSnapshotFilename(), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	FNameAsStringProxyArchive Ar(Reader);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	FSHAHash Key;
+	Ar << Magic;
+	Ar << Version;
+	Ar << Key;
+
+	if (Ar.IsError() || Magic != RPGAssetSnapshot::Magic || Version != RPGAssetSnapshot::Version || Key != SnapshotKey)
+	{
+		UE_LOG(LogActionRPG, Log, TEXT("Primary asset snapshot is stale, scanning"));
+		return false;
+	}
+
+	int32 NumTypes = 0;
+	Ar << NumTypes;
+	if (Ar.IsError() || NumTypes < 0 || NumTypes > Bytes.Num())
+	{
+		return false;
+	}
+
+	// Read everything before using any of it, so a truncated snapshot falls back to a clean scan
+	int32 NumAssets = 0;
+	for (int32 TypeIndex = 0; TypeIndex < NumTypes; TypeIndex++)
+	{
+		FPrimaryAssetType AssetType;
+		int32 NumTypeAssets = 0;
+		Ar << AssetType;
+		Ar << NumTypeAssets;
+		if (Ar.IsError() || NumTypeAssets < 0 || NumTypeAssets > Bytes.Num())
+		{
+			OutAssets.Reset();
+			return false;
+		}
+
+		TArray<FAssetData>& TypeAssets = OutAssets.FindOrAdd(AssetType);
+		TypeAssets.SetNum(NumTypeAssets);
+		for (FAssetData& AssetData : TypeAssets)
+		{
+			RPGAssetSnapshot::SerializeAssetData(Ar, AssetData);
+			if (Ar.IsError())
+			{
+				UE_LOG(LogActionRPG, Warning, TEXT("Primary asset snapshot is corrupt, scanning"));
+				OutAssets.Reset();
+				return false;
+			}
+		}
+		NumAssets += NumTypeAssets;
+	}
+
+	UE_LOG(LogActionRPG, Log, TEXT("Read %d primary assets of %d types from snapshot"), NumAssets, NumTypes);
+	return true;
+}
+
+void URPGAssetManager::DeletePrimaryAssetSnapshot()
+{
+	IFileManager::Get().Delete(*RPGAssetSnapshot::GetSnapshotFilename(), false, false, true);
+}
+
+bool URPGAssetManager::SavePrimaryAssetSnapshot(const FSHAHash& SnapshotKey) const
+{
+	// Only types scanned from config are read back from the snapshot, dynamic assets are added by the game at runtime
+	TMap<FPrimaryAssetType, TArray<FAssetData>> Assets;
+	int32 NumAssets = 0;
+
+	TArray<FPrimaryAssetTypeInfo> TypeInfos;
+	GetPrimaryAssetTypeInfoList(TypeInfos);
+	for (const FPrimaryAssetTypeInfo& TypeInfo : TypeInfos)
+	{
+		if (TypeInfo.bIsDynamicAsset)
+		{
+			continue;
+		}
+
+		TArray<FAssetData>& TypeAssets = Assets.Add(TypeInfo.PrimaryAssetType);
+		GetPrimaryAssetDataList(TypeInfo.PrimaryAssetType, TypeAssets);
+		NumAssets += TypeAssets.Num();
+	}
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	FNameAsStringProxyArchive Ar(Writer);
+
+	uint32 Magic = RPGAssetSnapshot::Magic;
+	int32 Version = RPGAssetSnapshot::Version;
+	FSHAHash Key = SnapshotKey;
+	int32 NumTypes = Assets.Num();
+	Ar << Magic;
+	Ar << Version;
+	Ar << Key;
+	Ar << NumTypes;
+
+	for (TPair<FPrimaryAssetType, TArray<FAssetData>>& TypePair : Assets)
+	{
+		int32 NumTypeAssets = TypePair.Value.Num();
+		Ar << TypePair.Key;
+		Ar << NumTypeAssets;
+
+		for (FAssetData& AssetData : TypePair.Value)
+		{
+			RPGAssetSnapshot::SerializeAssetData(Ar, AssetData);
+		}
+	}
+
+	const FString Filename = RPGAssetSnapshot::GetSnapshotFilename();
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Filename))
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("Failed to write primary asset snapshot to %s"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogActionRPG, Log, TEXT("Wrote %d primary assets to snapshot, %d bytes"), NumAssets, Bytes.Num());
+	return true;
+}
 
-	UAbilitySystemGlobals::Get().InitGlobalData();
+void URPGAssetManager::HandlePreLoadMap(const FString& MapName)
+{
+	PreloadMapAssets(MapName);
+}
+
+bool URPGAssetManager::PreloadMapAssets(const FString& MapName)
+{
+	// Accepts package names and URLs, the manifest is keyed by the short map name
+	FString MapPackageName = MapName;
+	MapPackageName.Split(TEXT("?"), &MapPackageName, nullptr);
+	const FString Section = FString::Printf(TEXT("RPGMapPreload %s"), *FPackageName::GetShortName(MapPackageName));
+
+	TArray<FString> PrimaryAssetTypes;
+	TArray<FString> Bundles;
+	TArray<FString> AssetPaths;
+	GConfig->GetArray(*Section, TEXT("PrimaryAssetTypes"), PrimaryAssetTypes, GGameIni);
+	GConfig->GetArray(*Section, TEXT("Bundles"), Bundles, GGameIni);
+	GConfig->GetArray(*Section, TEXT("Assets"), AssetPaths, GGameIni);
+
+	if (PrimaryAssetTypes.Num() == 0 && AssetPaths.Num() == 0)
+	{
+		// Nothing to keep loaded for this map
+		if (MapPreloadHandle.IsValid())
+		{
+			MapPreloadHandle->ReleaseHandle();
+			MapPreloadHandle.Reset();
+		}
+		return false;
+	}
+
+	TArray<FPrimaryAssetId> AssetIds;
+	for (const FString& PrimaryAssetType : PrimaryAssetTypes)
+	{
+		GetPrimaryAssetIdList(FPrimaryAssetType(*PrimaryAssetType), AssetIds);
+	}
+
+	TArray<FName> BundleNames;
+	for (const FString& Bundle : Bundles)
+	{
+		BundleNames.Add(*Bundle);
+	}
+
+	TArray<FSoftObjectPath> ExtraAssets;
+	for (const FString& AssetPath : AssetPaths)
+	{
+		ExtraAssets.Emplace(AssetPath);
+	}
+
+	// The old preload is kept until the new one is done, otherwise assets both maps use would unload and load again
+	if (MapPreloadHandle.IsValid())
+	{
+		if (PreviousMapPreloadHandle.IsValid())
+		{
+			PreviousMapPreloadHandle->ReleaseHandle();
+		}
+		PreviousMapPreloadHandle = MapPreloadHandle;
+	}
+
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+	if (AssetIds.Num() > 0)
+	{
+		TSharedPtr<FStreamableHandle> PrimaryAssetHandle = LoadPrimaryAssets(AssetIds, BundleNames, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+		if (PrimaryAssetHandle.IsValid())
+		{
+			Handles.Add(PrimaryAssetHandle);
+		}
+	}
+	if (ExtraAssets.Num() > 0)
+	{
+		TSharedPtr<FStreamableHandle> ExtraAssetHandle = GetStreamableManager().RequestAsyncLoad(ExtraAssets, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("MapPreload"));
+		if (ExtraAssetHandle.IsValid())
+		{
+			Handles.Add(ExtraAssetHandle);
+		}
+	}
+
+	UE_LOG(LogActionRPG, Log, TEXT("Preloading %d primary assets and %d assets for %s"), AssetIds.Num(), ExtraAssets.Num(), *MapPackageName);
+
+	MapPreloadHandle = Handles.Num() == 1 ? Handles[0] : (Handles.Num() > 1 ? GetStreamableManager().CreateCombinedHandle(Handles, TEXT("MapPreload")) : nullptr);
+	if (!MapPreloadHandle.IsValid() || MapPreloadHandle->HasLoadCompleted())
+	{
+		HandleMapPreloadComplete();
+		return true;
+	}
+
+	MapPreloadHandle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateUObject(this, &URPGAssetManager::HandleMapPreloadUpdate));
+	MapPreloadHandle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &URPGAssetManager::HandleMapPreloadComplete));
+	HandleMapPreloadUpdate(MapPreloadHandle.ToSharedRef());
+	return true;
+}
+
+float URPGAssetManager::GetMapPreloadProgress() const
+{
+	return MapPreloadHandle.IsValid() ? MapPreloadHandle->GetProgress() : 1.0f;
+}
+
+bool URPGAssetManager::IsMapPreloadComplete() const
+{
+	return !MapPreloadHandle.IsValid() || MapPreloadHandle->HasLoadCompleted();
+}
+
+void URPGAssetManager::HandleMapPreloadUpdate(TSharedRef<FStreamableHandle> Handle)
+{
+	if (IActionRPGLoadingScreenModule::IsAvailable())
+	{
+		IActionRPGLoadingScreenModule::Get().SetLoadingTaskProgress(MapPreloadTaskName, Handle->GetProgress());
+	}
+}
+
+void URPGAssetManager::HandleMapPreloadComplete()
+{
+	if (PreviousMapPreloadHandle.IsValid())
+	{
+		PreviousMapPreloadHandle->ReleaseHandle();
+		PreviousMapPreloadHandle.Reset();
+	}
+
+	if (IActionRPGLoadingScreenModule::IsAvailable())
+	{
+		IActionRPGLoadingScreenModule::Get().EndLoadingTask(MapPreloadTaskName);
+	}
+
+	OnMapPreloadComplete.Broadcast();
+}
+
+void URPGAssetManager::BuildItemRegistry()
+{
+	RPG_BOOT_PHASE_SCOPE(TEXT("BuildItemRegistry"));
+
+	if (ItemRegistryHandle.IsValid())
+	{
+		ItemRegistryHandle->CancelHandle();
+		ItemRegistryHandle.Reset();
+	}
+
+	RegisteredItemIds.Reset();
+	RegisteredItemLookup.Reset();
+	ItemTypeRanges.Reset();
+	ResidentItems.Reset();
+	bItemRegistryResident = false;
+
+	static const FPrimaryAssetType ItemTypes[] = { PotionItemType, SkillItemType, TokenItemType, WeaponItemType };
+
+	for (const FPrimaryAssetType& ItemType : ItemTypes)
+	{
+		TArray<FPrimaryAssetId> TypeIds;
+		GetPrimaryAssetIdList(ItemType, TypeIds);
+
+		// Sort so ids only change when the item set changes, not with scan order
+		TypeIds.Sort([](const FPrimaryAssetId& A, const FPrimaryAssetId& B) { return A.PrimaryAssetName.LexicalLess(B.PrimaryAssetName); });
+
+		FRPGItemTypeRange& Range = ItemTypeRanges.AddDefaulted_GetRef();
+		Range.ItemType = ItemType;
+		Range.FirstId = RegisteredItemIds.Num();
+		Range.Num = TypeIds.Num();
+
+		for (const FPrimaryAssetId& ItemId : TypeIds)
+		{
+			RegisteredItemLookup.Add(ItemId, RegisteredItemIds.Add(ItemId));
+		}
+	}
+
+	ResidentItems.SetNumZeroed(RegisteredItemIds.Num());
+
+	UE_LOG(LogActionRPG, Log, TEXT("Item registry built with %d items"), RegisteredItemIds.Num());
+
+	// Items the save game uses are loaded by the inventory, the rest are only needed once play has started
+	RPGBoot::DeferUntilFirstFrame([this]()
+	{
+		PreloadItemRegistry();
+	});
+}
+
+void URPGAssetManager::PreloadItemRegistry()
+{
+	if (bItemRegistryResident || ItemRegistryHandle.IsValid())
+	{
+		return;
+	}
+
+	RPGBoot::BeginPhase(TEXT("ItemRegistryPreload"));
+
+	// Preload every item so lookups never hit the disk
+	ItemRegistryHandle = LoadPrimaryAssets(RegisteredItemIds, TArray<FName>(), FStreamableDelegate::CreateUObject(this, &URPGAssetManager::HandleItemRegistryLoaded));
+	if (!ItemRegistryHandle.IsValid() || ItemRegistryHandle->HasLoadCompleted())
+	{
+		HandleItemRegistryLoaded();
+	}
+}
+
+void URPGAssetManager::HandleItemRegistryLoaded()
+{
+	if (bItemRegistryResident)
+	{
+		return;
+	}
+
+	for (int32 ItemId = 0; ItemId < RegisteredItemIds.Num(); ItemId++)
+	{
+		ResidentItems[ItemId] = GetPrimaryAssetObject<URPGItem>(RegisteredItemIds[ItemId]);
+	}
+
+	bItemRegistryResident = true;
+
+	RPGBoot::EndPhase(TEXT("ItemRegistryPreload"));
+}
+
+URPGItem* URPGAssetManager::FindLoadedItem(const FPrimaryAssetId& PrimaryAssetId) const
+{
+	if (URPGItem* RegisteredItem = GetRegisteredItem(GetItemRegistryId(PrimaryAssetId)))
+	{
+		return RegisteredItem;
+	}
+
+	return GetPrimaryAssetObject<URPGItem>(PrimaryAssetId);
+}
+
+int32 URPGAssetManager::GetItemRegistryId(const FPrimaryAssetId& PrimaryAssetId) const
+{
+	const int32* FoundId = RegisteredItemLookup.Find(PrimaryAssetId);
+	return FoundId ? *FoundId : INDEX_NONE;
+}
+
+FPrimaryAssetId URPGAssetManager::GetRegisteredItemAssetId(int32 ItemId) const
+{
+	return RegisteredItemIds.IsValidIndex(ItemId) ? RegisteredItemIds[ItemId] : FPrimaryAssetId();
+}
+
+URPGItem* URPGAssetManager::GetRegisteredItem(int32 ItemId) const
+{
+	return ResidentItems.IsValidIndex(ItemId) ? ResidentItems[ItemId].Get() : nullptr;
+}
+
+bool URPGAssetManager::GetItemTypeRange(FPrimaryAssetType ItemType, FRPGItemTypeRange& OutRange) const
+{
+	for (const FRPGItemTypeRange& Range : ItemTypeRanges)
+	{
+		if (Range.ItemType == ItemType)
+		{
+			OutRange = Range;
+			return Range.Num > 0;
+		}
+	}
+	return false;
+}
+
+void URPGAssetManager::BakeCurveTables()
+{
+	static const TCHAR* ConfigSection = TEXT("/Script/ActionRPG.RPGAssetManager");
+
+	TArray<FString> CurveTablePaths;
+	GConfig->GetArray(ConfigSection, TEXT("BakedCurveTables"), CurveTablePaths, GGameIni);
+	GConfig->GetInt(ConfigSection, TEXT("MaxBakedLevel"), MaxBakedLevel, GGameIni);
+
+	if (MaxBakedLevel <= 0 || CurveTablePaths.Num() == 0)
+	{
+		return;
+	}
+
+	for (const FString& CurveTablePath : CurveTablePaths)
+	{
+		// This does a synchronous load, which is fine during initial loading
+		UCurveTable* CurveTable = LoadObject<UCurveTable>(nullptr, *CurveTablePath);
+		if (!CurveTable)
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("Failed to load curve table %s for baking!"), *CurveTablePath);
+			continue;
+		}
+
+		BakedCurveTables.Add(CurveTable);
+
+		for (const TPair<FName, FRealCurve*>& RowPair : CurveTable->GetRowMap())
+		{
+			if (!RowPair.Value)
+			{
+				continue;
+			}
+
+			const int32 RowOffset = BakedCurveValues.AddUninitialized(MaxBakedLevel);
+			for (int32 Level = 1; Level <= MaxBakedLevel; Level++)
+			{
+				BakedCurveValues[RowOffset + Level - 1] = RowPair.Value->Eval((float)Level);
+			}
+
+			BakedCurveRows.Add(TPair<const UCurveTable*, FName>(CurveTable, RowPair.Key), RowOffset);
+		}
+	}
+
+	UE_LOG(LogActionRPG, Log, TEXT("Baked %d curve rows from %d tables up to level %d"), BakedCurveRows.Num(), BakedCurveTables.Num(), MaxBakedLevel);
+}
+
+float URPGAssetManager::GetCurveValueAtLevel(const UCurveTable* CurveTable, FName RowName, int32 Level) const
+{
+	if (!CurveTable)
+	{
+		return 0.0f;
+	}
+
+	if (Level >= 1 && Level <= MaxBakedLevel)
+	{
+		if (const int32* RowOffset = BakedCurveRows.Find(TPair<const UCurveTable*, FName>(CurveTable, RowName)))
+		{
+			return BakedCurveValues[*RowOffset + Level - 1];
+		}
+	}
+
+	const FRealCurve* Curve = CurveTable->FindCurve(RowName, TEXT("URPGAssetManager::GetCurveValueAtLevel"), false);
+	return Curve ? Curve->Eval((float)Level) : 0.0f;
+}
+
+float URPGAssetManager::GetScalableFloatAtLevel(const FScalableFloat& ScalableFloat, int32 Level) const
+{
+	if (ScalableFloat.Curve.CurveTable)
+	{
+		return ScalableFloat.Value * GetCurveValueAtLevel(ScalableFloat.Curve.CurveTable, ScalableFloat.Curve.RowName, Level);
+	}
+
+	return ScalableFloat.Value;
 }
 
 
 URPGItem* URPGAssetManager::ForceLoadItem(const FPrimaryAssetId& PrimaryAssetId, bool bLogWarning)
 {	
+	// Resident items don't need a path lookup or load
+	if (URPGItem* RegisteredItem = GetRegisteredItem(GetItemRegistryId(PrimaryAssetId)))
+	{
+		return RegisteredItem;
+	}
+
 	FSoftObjectPath ItemPath = GetPrimaryAssetPath(PrimaryAssetId);
 
 	// This does a synchronous load and may hitch
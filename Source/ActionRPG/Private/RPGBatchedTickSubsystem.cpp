@@ -0,0 +1,349 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGBatchedTickSubsystem.h"
+#include "RPGBenchmark.h"
+#include "RPGCharacterBase.h"
+#include "RPGArcherCharacter.h"
+#include "RPGArcherEnemy.h"
+#include "RPGSignificanceSubsystem.h"
+#include "Abilities/RPGArcaneMissile.h"
+#include "AI/RPGStateTreeTask_RandomPatrol.h"
+#include "AI/RPGStateTreeTask_FireArrow.h"
+#include "AIController.h"
+#include "Navigation/PathFollowingComponent.h"
+
+void FRPGMissileHomingBatch::Register(ARPGArcaneMissile* Missile)
+{
+	if (Missile)
+	{
+		FRPGMissileHomingItem& Item = FindOrAdd(Missile);
+		Item.Missile = Missile;
+	}
+}
+
+void FRPGMissileHomingBatch::SetTickInterval(const AActor* Missile, float TickInterval)
+{
+	if (FRPGMissileHomingItem* Item = Find(Missile))
+	{
+		Item->TickInterval = TickInterval;
+	}
+}
+
+void FRPGMissileHomingBatch::Gather(UWorld* World, float DeltaTime)
+{
+	for (FRPGMissileHomingItem& Item : Items)
+	{
+		Item.bStep = false;
+		Item.TimeSinceStep += DeltaTime;
+
+		ARPGArcaneMissile* Missile = Item.Missile.Get();
+		UProjectileMovementComponent* Movement = Missile ? Missile->GetProjectileMovement() : nullptr;
+		if (!Movement || Item.TimeSinceStep < Item.TickInterval)
+		{
+			continue;
+		}
+
+		Item.StepTime = Item.TimeSinceStep;
+		Item.TimeSinceStep = 0.0f;
+
+		// Finding a new target searches the world, so it stays on the game thread
+		AActor* Target = Missile->UpdateHomingTarget();
+		if (!Target)
+		{
+			continue;
+		}
+
+		Item.Location = Missile->GetActorLocation();
+		Item.TargetLocation = Target->GetActorLocation();
+		Item.Velocity = Movement->Velocity;
+		Item.MaxSpeed = Movement->MaxSpeed;
+		Item.HomingAcceleration = Missile->GetHomingAcceleration();
+		Item.bStep = true;
+	}
+}
+
+void FRPGMissileHomingBatch::TickItem(FRPGMissileHomingItem& Item, float DeltaTime) const
+{
+	if (Item.bStep)
+	{
+		Item.Velocity = ARPGArcaneMissile::CalculateHomingVelocity(Item.Location, Item.TargetLocation, Item.Velocity, Item.MaxSpeed, Item.HomingAcceleration, Item.StepTime);
+	}
+}
+
+void FRPGMissileHomingBatch::Apply(float DeltaTime)
+{
+	for (const FRPGMissileHomingItem& Item : Items)
+	{
+		ARPGArcaneMissile* Missile = Item.bStep ? Item.Missile.Get() : nullptr;
+		if (UProjectileMovementComponent* Movement = Missile ? Missile->GetProjectileMovement() : nullptr)
+		{
+			Movement->Velocity = Item.Velocity;
+		}
+	}
+}
+
+void FRPGPerceptionBatch::Register(AActor* Agent)
+{
+	if (Agent)
+	{
+		FRPGPerceptionItem& Item = FindOrAdd(Agent);
+		Item.Agent = Agent;
+	}
+}
+
+bool FRPGPerceptionBatch::FindNearestTarget(const AActor* Agent, float Range, AActor*& OutTarget) const
+{
+	const FRPGPerceptionItem* Item = Find(Agent);
+	if (!Item || !Item->bPerceived)
+	{
+		return false;
+	}
+
+	OutTarget = Item->NearestDistanceSquared < FMath::Square(Range) ? Item->NearestTarget.Get() : nullptr;
+	return true;
+}
+
+void FRPGPerceptionBatch::Gather(UWorld* World, float DeltaTime)
+{
+	// Same targets the StateTree searches accepted, player controlled characters that are not archers
+	Targets.Reset();
+	for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		ARPGCharacterBase* Character = PlayerController ? Cast<ARPGCharacterBase>(PlayerController->GetPawn()) : nullptr;
+		if (Character && !Character->IsA<ARPGArcherCharacter>() && !Character->IsA<ARPGArcherEnemy>())
+		{
+			Targets.Add({ Character, Character->GetActorLocation() });
+		}
+	}
+
+	RPGStats::RecordTargetSearch(Targets.Num());
+
+	for (FRPGPerceptionItem& Item : Items)
+	{
+		if (const AActor* Agent = Item.Agent.Get())
+		{
+			Item.Location = Agent->GetActorLocation();
+		}
+	}
+}
+
+void FRPGPerceptionBatch::TickItem(FRPGPerceptionItem& Item, float DeltaTime) const
+{
+	Item.NearestTargetIndex = INDEX_NONE;
+	Item.NearestDistanceSquared = MAX_FLT;
+
+	for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); TargetIndex++)
+	{
+		if (Targets[TargetIndex].Actor == Item.Agent)
+		{
+			continue;
+		}
+
+		const float DistanceSquared = FVector::DistSquared(Item.Location, Targets[TargetIndex].Location);
+		if (DistanceSquared < Item.NearestDistanceSquared)
+		{
+			Item.NearestDistanceSquared = DistanceSquared;
+			Item.NearestTargetIndex = TargetIndex;
+		}
+	}
+}
+
+void FRPGPerceptionBatch::Apply(float DeltaTime)
+{
+	for (FRPGPerceptionItem& Item : Items)
+	{
+		Item.NearestTarget = Item.NearestTargetIndex != INDEX_NONE ? Targets[Item.NearestTargetIndex].Actor : nullptr;
+		Item.bPerceived = true;
+	}
+}
+
+void FRPGPatrolBatch::Register(AAIController* Controller, const FVector& PatrolLocation, float PatrolRadius)
+{
+	if (APawn* Pawn = Controller ? Controller->GetPawn() : nullptr)
+	{
+		FRPGPatrolItem& Item = FindOrAdd(Pawn);
+		Item.Controller = Controller;
+		Item.PatrolLocation = PatrolLocation;
+		Item.PatrolRadius = PatrolRadius;
+		Item.bNeedsPatrolLocation = false;
+	}
+}
+
+void FRPGPatrolBatch::Gather(UWorld* World, float DeltaTime)
+{
+	for (FRPGPatrolItem& Item : Items)
+	{
+		// Items without a pawn are skipped in Apply
+		const AAIController* Controller = Item.Controller.Get();
+		const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+		if (Pawn)
+		{
+			const UPathFollowingComponent* PathFollowing = Controller->GetPathFollowingComponent();
+			Item.bIsMoving = PathFollowing && PathFollowing->GetStatus() != EPathFollowingStatus::Idle;
+			Item.Location = Pawn->GetActorLocation();
+		}
+	}
+}
+
+void FRPGPatrolBatch::TickItem(FRPGPatrolItem& Item, float DeltaTime) const
+{
+	Item.bNeedsPatrolLocation = !Item.bIsMoving || FVector::DistSquared(Item.Location, Item.PatrolLocation) < FMath::Square(150.0f);
+}
+
+void FRPGPatrolBatch::Apply(float DeltaTime)
+{
+	for (FRPGPatrolItem& Item : Items)
+	{
+		AAIController* Controller = Item.bNeedsPatrolLocation ? Item.Controller.Get() : nullptr;
+		APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		// Navigation queries and move requests have to be made on the game thread
+		Item.PatrolLocation = FRPGStateTreeTask_RandomPatrol::GetRandomPatrolLocation(Pawn->GetActorLocation(), Item.PatrolRadius, Pawn);
+
+		FAIMoveRequest MoveRequest(Item.PatrolLocation);
+		MoveRequest.SetAcceptanceRadius(50.0f);
+		MoveRequest.SetUsePathfinding(true);
+		Controller->MoveTo(MoveRequest);
+	}
+}
+
+bool RPGAIDecision::GatherSnapshot(FRPGAIDecisionItem& Item, float DeltaTime)
+{
+	Item.bDecide = false;
+	Item.TimeSinceDecision += DeltaTime;
+
+	const APawn* Agent = Item.Agent.Get();
+	const AActor* Target = Item.Target.Get();
+	if (!Agent || !Target)
+	{
+		Item.Status = EStateTreeRunStatus::Failed;
+		return false;
+	}
+
+	// Distant agents decide as often as their significance tier lets the AI brain think
+	if (Item.TimeSinceDecision < URPGSignificanceSubsystem::GetActorTierSettings(Agent).AIThinkInterval)
+	{
+		return false;
+	}
+
+	Item.StepTime = Item.TimeSinceDecision;
+	Item.TimeSinceDecision = 0.0f;
+
+	Item.Location = Agent->GetActorLocation();
+	Item.Rotation = Agent->GetActorRotation();
+	Item.TargetLocation = Target->GetActorLocation();
+
+	const AAIController* Controller = Cast<AAIController>(Agent->GetController());
+	const UPathFollowingComponent* PathFollowing = Controller ? Controller->GetPathFollowingComponent() : nullptr;
+	Item.bIsMoving = PathFollowing && PathFollowing->GetStatus() != EPathFollowingStatus::Idle;
+
+	Item.bDecide = true;
+	return true;
+}
+
+void FRPGChaseDecisionBatch::DecideItem(FRPGChaseDecisionItem& Item)
+{
+	// Path following tracks a moving goal actor by itself, the move only needs to be requested again once it stopped
+	if (!Item.bIsMoving)
+	{
+		if (AAIController* Controller = Cast<AAIController>(Item.Agent->GetController()))
+		{
+			Controller->MoveToActor(Item.Target.Get(), Item.AcceptanceRadius);
+		}
+	}
+}
+
+void FRPGFireArrowDecisionBatch::DecideItem(FRPGFireArrowDecisionItem& Item)
+{
+	APawn* Agent = Item.Agent.Get();
+	Item.TimeSinceLastAttack += Item.StepTime;
+
+	// Keep facing the target
+	const FRotator TargetRotation = (Item.TargetLocation - Item.Location).GetSafeNormal().Rotation();
+	Agent->SetActorRotation(FMath::RInterpTo(Item.Rotation, TargetRotation, Item.StepTime, 5.0f));
+
+	// Fire once the cooldown is up, after turning so the arrow leaves from the new facing
+	if (Item.TimeSinceLastAttack >= Item.AttackCooldown)
+	{
+		FRPGStateTreeTask_FireArrow::SpawnArrow(Agent, Item.Target.Get(), Item.ArrowProjectileClass);
+		Item.TimeSinceLastAttack = 0.0f;
+	}
+}
+
+void FRPGRetreatDecisionBatch::DecideItem(FRPGRetreatDecisionItem& Item)
+{
+	// Done once far enough from the target or at the retreat location
+	const float DistanceToPlayer = FVector::Dist(Item.Location, Item.TargetLocation);
+	const float DistanceToRetreatLocation = FVector::Dist(Item.Location, Item.RetreatLocation);
+	if (DistanceToPlayer >= Item.RetreatDistance * 0.8f || DistanceToRetreatLocation < 150.0f)
+	{
+		Item.Status = EStateTreeRunStatus::Succeeded;
+	}
+}
+
+URPGBatchedTickSubsystem::URPGBatchedTickSubsystem()
+	: bBatchedAIDecisions(true)
+	, bParallelBatchedTicks(true)
+	, ParallelBatchThreshold(32)
+{
+}
+
+bool URPGBatchedTickSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId URPGBatchedTickSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URPGBatchedTickSubsystem, STATGROUP_Tickables);
+}
+
+URPGBatchedTickSubsystem* URPGBatchedTickSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<URPGBatchedTickSubsystem>() : nullptr;
+}
+
+URPGBatchedTickSubsystem* URPGBatchedTickSubsystem::GetForAIDecisions(const UObject* WorldContextObject)
+{
+	URPGBatchedTickSubsystem* Subsystem = Get(WorldContextObject);
+	return Subsystem && Subsystem->bBatchedAIDecisions ? Subsystem : nullptr;
+}
+
+void URPGBatchedTickSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_BatchedTick);
+
+	{
+		RPG_BENCHMARK_SCOPE(AITick);
+		RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_PerceptionBatch);
+		Perception.Tick(GetWorld(), DeltaTime, bParallelBatchedTicks, ParallelBatchThreshold);
+	}
+
+	{
+		RPG_BENCHMARK_SCOPE(AITick);
+		RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_PatrolBatch);
+		Patrol.Tick(GetWorld(), DeltaTime, bParallelBatchedTicks, ParallelBatchThreshold);
+	}
+
+	{
+		RPG_BENCHMARK_SCOPE(AITick);
+		RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_AIDecisionBatch);
+		ChaseDecisions.TickDecisions(DeltaTime);
+		FireArrowDecisions.TickDecisions(DeltaTime);
+		RetreatDecisions.TickDecisions(DeltaTime);
+	}
+
+	{
+		RPG_BENCHMARK_SCOPE(Projectile);
+		RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_MissileHomingBatch);
+		MissileHoming.Tick(GetWorld(), DeltaTime, bParallelBatchedTicks, ParallelBatchThreshold);
+	}
+}
@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGBenchmark.h"
+
+bool FRPGBenchmark::bActive = false;
+double FRPGBenchmark::FrameSeconds[(int32)ERPGBenchmarkBucket::Num] = {};
+int64 FRPGBenchmark::CallCounts[(int32)ERPGBenchmarkBucket::Num] = {};
+TArray<float> FRPGBenchmark::FrameSamples[(int32)ERPGBenchmarkBucket::Num];
+int32 FRPGBenchmark::ScopeDepths[(int32)ERPGBenchmarkBucket::Num] = {};
+
+void FRPGBenchmark::Start()
+{
+	for (int32 Index = 0; Index < (int32)ERPGBenchmarkBucket::Num; Index++)
+	{
+		FrameSeconds[Index] = 0.0;
+		CallCounts[Index] = 0;
+		FrameSamples[Index].Reset();
+	}
+
+	bActive = true;
+}
+
+void FRPGBenchmark::Stop()
+{
+	bActive = false;
+}
+
+void FRPGBenchmark::AddTime(ERPGBenchmarkBucket Bucket, double Seconds)
+{
+	if (bActive && IsInGameThread())
+	{
+		FrameSeconds[(int32)Bucket] += Seconds;
+		CallCounts[(int32)Bucket]++;
+	}
+}
+
+void FRPGBenchmark::EndFrame()
+{
+	if (!bActive)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < (int32)ERPGBenchmarkBucket::Num; Index++)
+	{
+		FrameSamples[Index].Add((float)(FrameSeconds[Index] * 1000.0));
+		FrameSeconds[Index] = 0.0;
+	}
+}
+
+const TArray<float>& FRPGBenchmark::GetFrameSamples(ERPGBenchmarkBucket Bucket)
+{
+	return FrameSamples[(int32)Bucket];
+}
+
+int64 FRPGBenchmark::GetCallCount(ERPGBenchmarkBucket Bucket)
+{
+	return CallCounts[(int32)Bucket];
+}
+
+const TCHAR* FRPGBenchmark::GetBucketName(ERPGBenchmarkBucket Bucket)
+{
+	switch (Bucket)
+	{
+	case ERPGBenchmarkBucket::AITick:
+		return TEXT("ai_tick");
+	case ERPGBenchmarkBucket::Projectile:
+		return TEXT("projectile");
+	case ERPGBenchmarkBucket::GameplayEffectExecute:
+		return TEXT("gas_execute");
+	case ERPGBenchmarkBucket::AttributeCallback:
+		return TEXT("attribute_callbacks");
+	default:
+		return TEXT("unknown");
+	}
+}
@@ -0,0 +1,304 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGBootProfile.h"
+#include "ActionRPG.h"
+#include "RPGPlayerControllerBase.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Containers/Ticker.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+namespace RPGBoot
+{
+	struct FPhaseRecord
+	{
+		FName Name;
+		double StartTime = 0.0;
+		double EndTime = -1.0;
+	};
+
+	/** Boot state, everything here is only touched from the game thread */
+	static TArray<FPhaseRecord> Phases;
+	static TArray<TPair<FName, double>> Events;
+	static TArray<TFunction<void()>> DeferredWork;
+	static FDelegateHandle FirstFrameHandle;
+	static FDelegateHandle InteractiveFrameHandle;
+	static FTSTicker::FDelegateHandle InteractiveTimeoutHandle;
+	static bool bFirstFrameRequested = false;
+	static bool bFirstFrame = false;
+	static bool bInteractiveRequested = false;
+	static bool bFinished = false;
+
+	/** Gives up waiting for the local player this long after the first frame, for clients whose controller never arrives */
+	static const float InteractiveTimeout = 60.0f;
+
+	/** Seconds since the process started */
+	static double GetBootTime()
+	{
+		return FPlatformTime::Seconds() - GStartTime;
+	}
+
+	static FString GetReportPath(bool& bOutRequired)
+	{
+		FString ReportPath;
+		if (FParse::Value(FCommandLine::Get(), TEXT("RPGStartupReport="), ReportPath))
+		{
+			bOutRequired = true;
+			return ReportPath;
+		}
+
+		bool bWriteReport = false;
+		GConfig->GetBool(TEXT("/Script/ActionRPG.RPGAssetManager"), TEXT("bWriteStartupReport"), bWriteReport, GGameIni);
+
+		bOutRequired = bWriteReport || FParse::Param(FCommandLine::Get(), TEXT("nullrhi"));
+		return FPaths::ProjectLogDir() / TEXT("StartupReport.json");
+	}
+
+	static void WriteReport(const FString& ReportPath)
+	{
+		FString Json;
+		TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("build"), LexToString(FApp::GetBuildConfiguration()));
+		Writer->WriteValue(TEXT("platform"), FPlatformProperties::IniPlatformName());
+		Writer->WriteValue(TEXT("fast_boot"), IsFastBoot());
+		Writer->WriteValue(TEXT("total_s"), GetBootTime());
+
+		Writer->WriteArrayStart(TEXT("phases"));
+		for (const FPhaseRecord& Record : Phases)
+		{
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("name"), Record.Name.ToString());
+			Writer->WriteValue(TEXT("start_s"), Record.StartTime);
+			if (Record.EndTime >= 0.0)
+			{
+				Writer->WriteValue(TEXT("end_s"), Record.EndTime);
+				Writer->WriteValue(TEXT("duration_s"), Record.EndTime - Record.StartTime);
+			}
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+
+		Writer->WriteArrayStart(TEXT("events"));
+		for (const TPair<FName, double>& Event : Events)
+		{
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("name"), Event.Key.ToString());
+			Writer->WriteValue(TEXT("time_s"), Event.Value);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+
+		Writer->WriteObjectEnd();
+		Writer->Close();
+
+		if (FFileHelper::SaveStringToFile(Json, *ReportPath))
+		{
+			UE_LOG(LogActionRPG, Display, TEXT("Wrote startup report to %s"), *ReportPath);
+		}
+		else
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("Failed to write startup report to %s"), *ReportPath);
+		}
+	}
+
+	/** Logs the boot summary and writes the report, only the first call does anything */
+	static void FinishBoot()
+	{
+		if (bFinished)
+		{
+			return;
+		}
+		bFinished = true;
+
+		if (InteractiveTimeoutHandle.IsValid())
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(InteractiveTimeoutHandle);
+			InteractiveTimeoutHandle.Reset();
+		}
+
+		UE_LOG(LogActionRPG, Display, TEXT("Boot finished after %.3fs%s"), GetBootTime(), IsFastBoot() ? TEXT(" (fast boot)") : TEXT(""));
+		for (const FPhaseRecord& Record : Phases)
+		{
+			if (Record.EndTime >= 0.0)
+			{
+				UE_LOG(LogActionRPG, Display, TEXT("  %-32s %8.3fs  +%.3fs"), *Record.Name.ToString(), Record.StartTime, Record.EndTime - Record.StartTime);
+			}
+			else
+			{
+				UE_LOG(LogActionRPG, Display, TEXT("  %-32s %8.3fs  (unfinished)"), *Record.Name.ToString(), Record.StartTime);
+			}
+		}
+		for (const TPair<FName, double>& Event : Events)
+		{
+			UE_LOG(LogActionRPG, Display, TEXT("  %-32s %8.3fs"), *Event.Key.ToString(), Event.Value);
+		}
+
+		bool bReportRequired = false;
+		const FString ReportPath = GetReportPath(bReportRequired);
+		if (bReportRequired)
+		{
+			WriteReport(ReportPath);
+		}
+	}
+
+	static void HandleFirstFrame(TWeakObjectPtr<UWorld> WeakWorld)
+	{
+		FCoreDelegates::OnEndFrame.Remove(FirstFrameHandle);
+		FirstFrameHandle.Reset();
+
+		bFirstFrame = true;
+		MarkEvent(TEXT("FirstWorldFrame"));
+
+		if (DeferredWork.Num() > 0)
+		{
+			RPG_BOOT_PHASE_SCOPE(TEXT("DeferredStartupWork"));
+
+			TArray<TFunction<void()>> Work = MoveTemp(DeferredWork);
+			for (TFunction<void()>& Item : Work)
+			{
+				Item();
+			}
+		}
+
+		// Servers have nobody to wait for, and menus without an RPG controller never load an inventory
+		UWorld* World = WeakWorld.Get();
+		ULocalPlayer* LocalPlayer = (World && GEngine) ? GEngine->GetFirstGamePlayer(World) : nullptr;
+		APlayerController* PlayerController = LocalPlayer ? LocalPlayer->GetPlayerController(World) : nullptr;
+		if (!LocalPlayer || (PlayerController && !PlayerController->IsA<ARPGPlayerControllerBase>()))
+		{
+			FinishBoot();
+			return;
+		}
+
+		if (!bFinished && !bInteractiveRequested)
+		{
+			InteractiveTimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float)
+			{
+				InteractiveTimeoutHandle.Reset();
+				UE_LOG(LogActionRPG, Log, TEXT("Local player did not become interactive within %.0fs of the first frame"), InteractiveTimeout);
+				FinishBoot();
+				return false;
+			}), InteractiveTimeout);
+		}
+	}
+
+	void BeginPhase(FName Phase)
+	{
+		check(IsInGameThread());
+
+		if (bFinished)
+		{
+			return;
+		}
+
+		FPhaseRecord& Record = Phases.AddDefaulted_GetRef();
+		Record.Name = Phase;
+		Record.StartTime = GetBootTime();
+
+		TRACE_BOOKMARK(TEXT("RPGBoot Begin %s"), *Phase.ToString());
+	}
+
+	void EndPhase(FName Phase)
+	{
+		check(IsInGameThread());
+
+		if (bFinished)
+		{
+			return;
+		}
+
+		// Newest first so a phase that runs more than once closes the right record
+		for (int32 Index = Phases.Num() - 1; Index >= 0; Index--)
+		{
+			if (Phases[Index].Name == Phase && Phases[Index].EndTime < 0.0)
+			{
+				Phases[Index].EndTime = GetBootTime();
+				TRACE_BOOKMARK(TEXT("RPGBoot End %s"), *Phase.ToString());
+				return;
+			}
+		}
+	}
+
+	void MarkEvent(FName Event)
+	{
+		check(IsInGameThread());
+
+		if (bFinished)
+		{
+			return;
+		}
+
+		Events.Emplace(Event, GetBootTime());
+		TRACE_BOOKMARK(TEXT("RPGBoot %s"), *Event.ToString());
+	}
+
+	bool IsFastBoot()
+	{
+		static const bool bFastBoot = []()
+		{
+			if (GIsEditor || IsRunningCommandlet())
+			{
+				return false;
+			}
+
+			bool bConfigFastBoot = false;
+			GConfig->GetBool(TEXT("/Script/ActionRPG.RPGAssetManager"), TEXT("bFastBoot"), bConfigFastBoot, GGameIni);
+			return bConfigFastBoot || FParse::Param(FCommandLine::Get(), TEXT("RPGFastBoot"));
+		}();
+
+		return bFastBoot;
+	}
+
+	bool HasReachedFirstFrame()
+	{
+		return bFirstFrame;
+	}
+
+	void DeferUntilFirstFrame(TFunction<void()>&& Work)
+	{
+		check(IsInGameThread());
+
+		if (bFirstFrame || !IsFastBoot())
+		{
+			Work();
+			return;
+		}
+
+		DeferredWork.Add(MoveTemp(Work));
+	}
+
+	void NotifyMapLoaded(UWorld* World)
+	{
+		if (bFirstFrameRequested || !World || !World->IsGameWorld())
+		{
+			return;
+		}
+		bFirstFrameRequested = true;
+
+		MarkEvent(TEXT("MapLoaded"));
+		FirstFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&HandleFirstFrame, TWeakObjectPtr<UWorld>(World));
+	}
+
+	void NotifyInteractive()
+	{
+		if (bInteractiveRequested || bFinished)
+		{
+			return;
+		}
+		bInteractiveRequested = true;
+
+		// The frame the player can act in is the one being built now
+		InteractiveFrameHandle = FCoreDelegates::OnEndFrame.AddLambda([]()
+		{
+			FCoreDelegates::OnEndFrame.Remove(InteractiveFrameHandle);
+			InteractiveFrameHandle.Reset();
+
+			MarkEvent(TEXT("FirstInteractiveFrame"));
+			FinishBoot();
+		});
+	}
+}
@@ -1,12 +1,29 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "RPGCharacterBase.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
 #include "Items/RPGItem.h"
 #include "AbilitySystemGlobals.h"
 #include "Abilities/RPGGameplayAbility.h"
-
-ARPGCharacterBase::ARPGCharacterBase()
+#include "SkeletalMeshComponentBudgeted.h"
+#include "IAnimationBudgetAllocator.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "RPGCharacterMovementComponent.h"
+#include "RPGBatchedTickSubsystem.h"
+
+ARPGCharacterBase::ARPGCharacterBase(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer
+		.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName)
+		.SetDefaultSubobjectClass<URPGCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
+	// Animation update rate is handed to the budget allocator, which scales it by CalculateAnimationSignificance
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+	{
+		BudgetedMesh->SetAutoCalculateSignificance(true);
+	}
+
 	// Create ability system component, and set it to be explicitly replicated
 	AbilitySystemComponent = CreateDefaultSubobject<URPGAbilitySystemComponent>(TEXT("AbilitySystemComponent"));
 	AbilitySystemComponent->SetIsReplicated(true);
@@ -16,6 +33,24 @@ ARPGCharacterBase::ARPGCharacterBase()
 
 	CharacterLevel = 1;
 	bAbilitiesInitialized = false;
+
+	bAttributeFlushPending = false;
+	bImplementsOnDamaged = false;
+	bImplementsOnHealthChanged = false;
+	bImplementsOnManaChanged = false;
+	bImplementsOnMoveSpeedChanged = false;
+}
+
+void ARPGCharacterBase::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Blueprint events cost a VM call even when empty, so remember which ones the class actually overrides
+	const UClass* MyClass = GetClass();
+	bImplementsOnDamaged = MyClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(ARPGCharacterBase, OnDamaged));
+	bImplementsOnHealthChanged = MyClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(ARPGCharacterBase, OnHealthChanged));
+	bImplementsOnManaChanged = MyClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(ARPGCharacterBase, OnManaChanged));
+	bImplementsOnMoveSpeedChanged = MyClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(ARPGCharacterBase, OnMoveSpeedChanged));
 }
 
 UAbilitySystemComponent* ARPGCharacterBase::GetAbilitySystemComponent() const
@@ -45,6 +80,10 @@ void ARPGCharacterBase::AddStartupGameplayAbilities()
 			if (NewHandle.IsValid())
 			{
 				FActiveGameplayEffectHandle ActiveGEHandle = AbilitySystemComponent->ApplyGameplayEffectSpecToTarget(*NewHandle.Data.Get(), AbilitySystemComponent);
+				if (ActiveGEHandle.IsValid())
+				{
+					PassiveEffectHandles.Add(ActiveGEHandle);
+				}
 			}
 		}
 
@@ -80,6 +119,7 @@ void ARPGCharacterBase::RemoveStartupGameplayAbilities()
 		FGameplayEffectQuery Query;
 		Query.EffectSource = this;
 		AbilitySystemComponent->RemoveActiveEffects(Query);
+		PassiveEffectHandles.Reset();
 
 		RemoveSlottedGameplayAbilities(true);
 
@@ -87,13 +127,62 @@ void ARPGCharacterBase::RemoveStartupGameplayAbilities()
 	}
 }
 
+void ARPGCharacterBase::UpdateStartupAbilityLevels()
+{
+	check(AbilitySystemComponent);
+
+	if (GetLocalRole() == ROLE_Authority && bAbilitiesInitialized)
+	{
+		// Startup and default slotted abilities use this character as source
+		for (FGameplayAbilitySpec& Spec : AbilitySystemComponent->GetActivatableAbilities())
+		{
+			if (Spec.SourceObject == this && Spec.Level != CharacterLevel)
+			{
+				Spec.Level = CharacterLevel;
+				AbilitySystemComponent->MarkAbilitySpecDirty(Spec);
+			}
+		}
+
+		// Slotted item abilities use the character level too, except weapons which use the item's own level
+		TMap<FRPGItemSlot, FGameplayAbilitySpec> SlottedAbilitySpecs;
+		FillSlottedAbilitySpecs(SlottedAbilitySpecs);
+
+		for (const TPair<FRPGItemSlot, FGameplayAbilitySpecHandle>& SlottedPair : SlottedAbilities)
+		{
+			FGameplayAbilitySpec* Spec = AbilitySystemComponent->FindAbilitySpecFromHandle(SlottedPair.Value);
+			const FGameplayAbilitySpec* DesiredSpec = SlottedAbilitySpecs.Find(SlottedPair.Key);
+			if (Spec && DesiredSpec && Spec->SourceObject == DesiredSpec->SourceObject && Spec->Level != DesiredSpec->Level)
+			{
+				Spec->Level = DesiredSpec->Level;
+				AbilitySystemComponent->MarkAbilitySpecDirty(*Spec);
+			}
+		}
+
+		for (const FActiveGameplayEffectHandle& PassiveHandle : PassiveEffectHandles)
+		{
+			AbilitySystemComponent->SetActiveGameplayEffectLevel(PassiveHandle, CharacterLevel);
+		}
+	}
+}
+
 void ARPGCharacterBase::OnItemSlotChanged(FRPGItemSlot ItemSlot, URPGItem* Item)
 {
 	RefreshSlottedGameplayAbilities();
 }
 
+void ARPGCharacterBase::OnInventoryBatchChanged(const TArray<URPGItem*>& ChangedItems, const TArray<FRPGItemSlot>& ChangedSlots)
+{
+	// One refresh for the whole batch, and none if only counts changed
+	if (ChangedSlots.Num() > 0)
+	{
+		RefreshSlottedGameplayAbilities();
+	}
+}
+
 void ARPGCharacterBase::RefreshSlottedGameplayAbilities()
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_RefreshSlottedAbilities);
+
 	if (bAbilitiesInitialized)
 	{
 		// Refresh any invalid abilities and adds new ones
@@ -208,6 +297,7 @@ void ARPGCharacterBase::PossessedBy(AController* NewController)
 	{
 		InventoryUpdateHandle = InventorySource->GetSlottedItemChangedDelegate().AddUObject(this, &ARPGCharacterBase::OnItemSlotChanged);
 		InventoryLoadedHandle = InventorySource->GetInventoryLoadedDelegate().AddUObject(this, &ARPGCharacterBase::RefreshSlottedGameplayAbilities);
+		InventoryBatchHandle = InventorySource->GetInventoryBatchChangedDelegate().AddUObject(this, &ARPGCharacterBase::OnInventoryBatchChanged);
 	}
 
 	// Initialize our abilities
@@ -228,11 +318,140 @@ void ARPGCharacterBase::UnPossessed()
 
 		InventorySource->GetInventoryLoadedDelegate().Remove(InventoryLoadedHandle);
 		InventoryLoadedHandle.Reset();
+
+		InventorySource->GetInventoryBatchChangedDelegate().Remove(InventoryBatchHandle);
+		InventoryBatchHandle.Reset();
 	}
 
 	InventorySource = nullptr;
 }
 
+void ARPGCharacterBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Targets for StateTree nodes are found once per frame for every character instead of on each evaluation
+	if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(this))
+	{
+		BatchedTick->GetPerception().Register(this);
+	}
+
+	if (URPGSignificanceSubsystem* Significance = URPGSignificanceSubsystem::Get(this))
+	{
+		Significance->RegisterActor(this, FOnSignificanceTierChanged::CreateUObject(this, &ARPGCharacterBase::ApplySignificanceTier));
+	}
+}
+
+void ARPGCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (URPGSignificanceSubsystem* Significance = URPGSignificanceSubsystem::Get(this))
+	{
+		Significance->UnregisterActor(this);
+	}
+
+	if (URPGBatchedTickSubsystem* BatchedTick = URPGBatchedTickSubsystem::Get(this))
+	{
+		BatchedTick->GetPerception().Unregister(this);
+		BatchedTick->GetPatrol().Unregister(this);
+		BatchedTick->GetChaseDecisions().Unregister(this);
+		BatchedTick->GetFireArrowDecisions().Unregister(this);
+		BatchedTick->GetRetreatDecisions().Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ARPGCharacterBase::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	UpdateAnimationBudgetRegistration();
+
+	// The new controller may be a player, or an AI whose brain has not been throttled yet
+	if (HasActorBegunPlay())
+	{
+		ApplySignificanceTier(URPGSignificanceSubsystem::GetActorTier(this));
+	}
+}
+
+void ARPGCharacterBase::ApplySignificanceTier(ERPGSignificanceTier Tier)
+{
+	// Default settings are full fidelity
+	FRPGSignificanceTierSettings Settings;
+	URPGSignificanceSubsystem* Significance = URPGSignificanceSubsystem::Get(this);
+	if (Significance && !IsPlayerControlled())
+	{
+		Settings = Significance->GetTierSettings(Tier);
+	}
+
+	if (URPGCharacterMovementComponent* RPGMovement = Cast<URPGCharacterMovementComponent>(GetCharacterMovement()))
+	{
+		RPGMovement->SetSimplifiedMovement(Settings.bSimplifiedMovement, Settings.MovementTickInterval);
+	}
+	else if (UCharacterMovementComponent* Movement = GetCharacterMovement())
+	{
+		Movement->SetComponentTickInterval(Settings.MovementTickInterval);
+	}
+
+	if (AAIController* AIController = Cast<AAIController>(GetController()))
+	{
+		UBrainComponent* Brain = AIController->GetBrainComponent();
+		if (!Brain)
+		{
+			// StateTree components added in blueprint are not always set as the brain
+			Brain = AIController->FindComponentByClass<UBrainComponent>();
+		}
+
+		if (Brain)
+		{
+			Brain->SetComponentTickInterval(Settings.AIThinkInterval);
+		}
+	}
+}
+
+void ARPGCharacterBase::UpdateAnimationBudgetRegistration()
+{
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh());
+	UWorld* World = GetWorld();
+	IAnimationBudgetAllocator* BudgetAllocator = World ? IAnimationBudgetAllocator::Get(World) : nullptr;
+	if (!BudgetedMesh || !BudgetAllocator)
+	{
+		return;
+	}
+
+	// Meshes that have not begun play register themselves in BeginPlay, so only the flag needs to change
+	const bool bWantsBudget = !IsPlayerControlled();
+	BudgetedMesh->SetAutoRegisterWithBudgetAllocator(bWantsBudget);
+	if (!BudgetedMesh->HasBegunPlay())
+	{
+		return;
+	}
+
+	const bool bIsBudgeted = BudgetedMesh->GetAnimationBudgetHandle() != INDEX_NONE;
+	if (bWantsBudget && !bIsBudgeted)
+	{
+		BudgetAllocator->RegisterComponent(BudgetedMesh);
+	}
+	else if (!bWantsBudget && bIsBudgeted)
+	{
+		BudgetAllocator->UnregisterComponent(BudgetedMesh);
+	}
+}
+
+float ARPGCharacterBase::CalculateAnimationSignificance(USkeletalMeshComponentBudgeted* Component)
+{
+	INC_DWORD_STAT(STAT_RPG_AnimationSignificanceUpdates);
+
+	const AActor* Owner = Component ? Component->GetOwner() : nullptr;
+	const URPGSignificanceSubsystem* Significance = URPGSignificanceSubsystem::Get(Owner);
+	if (!Significance)
+	{
+		return 1.0f;
+	}
+
+	return Significance->GetSignificance(Owner) + (Component->WasRecentlyRendered(0.2f) ? 1.0f : 0.0f);
+}
+
 void ARPGCharacterBase::OnRep_Controller()
 {
 	Super::OnRep_Controller();
@@ -288,10 +507,17 @@ bool ARPGCharacterBase::SetCharacterLevel(int32 NewLevel)
 {
 	if (CharacterLevel != NewLevel && NewLevel > 0)
 	{
-		// Our level changed so we need to refresh abilities
-		RemoveStartupGameplayAbilities();
 		CharacterLevel = NewLevel;
-		AddStartupGameplayAbilities();
+
+		if (bAbilitiesInitialized)
+		{
+			// Keep the existing specs and only change their level, regranting everything is far too slow for mass level scaling
+			UpdateStartupAbilityLevels();
+		}
+		else
+		{
+			AddStartupGameplayAbilities();
+		}
 
 		return true;
 	}
@@ -380,9 +606,73 @@ bool ARPGCharacterBase::GetCooldownRemainingForTag(FGameplayTagContainer Cooldow
 	return false;
 }
 
+bool ARPGCharacterBase::WantsDamageNotifies() const
+{
+	return bImplementsOnDamaged || OnDamagedNative.IsBound();
+}
+
+void ARPGCharacterBase::QueueAttributeFlush(const struct FGameplayTagContainer& EventTags)
+{
+	PendingAttributeChanges.EventTags.AppendTags(EventTags);
+
+	if (!bAttributeFlushPending)
+	{
+		UWorld* World = GetWorld();
+		if (World)
+		{
+			// Everything that changes before next tick is merged into a single notification
+			bAttributeFlushPending = true;
+			World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &ARPGCharacterBase::FlushAttributeChanges));
+		}
+		else
+		{
+			FlushAttributeChanges();
+		}
+	}
+}
+
+void ARPGCharacterBase::FlushAttributeChanges()
+{
+	RPG_BENCHMARK_SCOPE(AttributeCallback);
+
+	bAttributeFlushPending = false;
+
+	if (!PendingAttributeChanges.HasChanges())
+	{
+		return;
+	}
+
+	// Copy out first so listeners can queue new changes while we broadcast
+	const FRPGAttributeChangeSet Changes = PendingAttributeChanges;
+	PendingAttributeChanges.Reset();
+
+	// Notify native before blueprint
+	OnAttributesChangedNative.Broadcast(Changes);
+
+	if (Changes.bHealthChanged && bImplementsOnHealthChanged)
+	{
+		OnHealthChanged(Changes.HealthDelta, Changes.EventTags);
+	}
+
+	if (Changes.bManaChanged && bImplementsOnManaChanged)
+	{
+		OnManaChanged(Changes.ManaDelta, Changes.EventTags);
+	}
+
+	if (Changes.bMoveSpeedChanged && bImplementsOnMoveSpeedChanged)
+	{
+		OnMoveSpeedChanged(Changes.MoveSpeedDelta, Changes.EventTags);
+	}
+}
+
 void ARPGCharacterBase::HandleDamage(float DamageAmount, const FHitResult& HitInfo, const struct FGameplayTagContainer& DamageTags, ARPGCharacterBase* InstigatorPawn, AActor* DamageCauser)
 {
-	OnDamaged(DamageAmount, HitInfo, DamageTags, InstigatorPawn, DamageCauser);	
+	OnDamagedNative.Broadcast(DamageAmount, HitInfo, DamageTags, InstigatorPawn, DamageCauser);
+
+	if (bImplementsOnDamaged)
+	{
+		OnDamaged(DamageAmount, HitInfo, DamageTags, InstigatorPawn, DamageCauser);
+	}
 }
 
 void ARPGCharacterBase::HandleHealthChanged(float DeltaValue, const struct FGameplayTagContainer& EventTags)
@@ -390,7 +680,15 @@ void ARPGCharacterBase::HandleHealthChanged(float DeltaValue, const struct FGame
 	// We only call the BP callback if this is not the initial ability setup
 	if (bAbilitiesInitialized)
 	{
-		OnHealthChanged(DeltaValue, EventTags);
+		PendingAttributeChanges.HealthDelta += DeltaValue;
+		PendingAttributeChanges.bHealthChanged = true;
+		QueueAttributeFlush(EventTags);
+
+		if (GetHealth() <= 0.f)
+		{
+			// Don't defer death handling to the next frame
+			FlushAttributeChanges();
+		}
 	}
 }
 
@@ -398,18 +696,22 @@ void ARPGCharacterBase::HandleManaChanged(float DeltaValue, const struct FGamepl
 {
 	if (bAbilitiesInitialized)
 	{
-		OnManaChanged(DeltaValue, EventTags);
+		PendingAttributeChanges.ManaDelta += DeltaValue;
+		PendingAttributeChanges.bManaChanged = true;
+		QueueAttributeFlush(EventTags);
 	}
 }
 
 void ARPGCharacterBase::HandleMoveSpeedChanged(float DeltaValue, const struct FGameplayTagContainer& EventTags)
 {
-	// Update the character movement's walk speed
+	// Update the character movement's walk speed right away, only the notification is deferred. Nav walking uses the same speed
 	GetCharacterMovement()->MaxWalkSpeed = GetMoveSpeed();
 
 	if (bAbilitiesInitialized)
 	{
-		OnMoveSpeedChanged(DeltaValue, EventTags);
+		PendingAttributeChanges.MoveSpeedDelta += DeltaValue;
+		PendingAttributeChanges.bMoveSpeedChanged = true;
+		QueueAttributeFlush(EventTags);
 	}
 }
 
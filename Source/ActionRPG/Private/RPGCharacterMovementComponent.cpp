@@ -0,0 +1,121 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGCharacterMovementComponent.h"
+#include "RPGStats.h"
+#include "GameFramework/Character.h"
+
+URPGCharacterMovementComponent::URPGCharacterMovementComponent()
+	: MaxSimplifiedMeshOffset(300.0f)
+	, SimplifiedNavMeshProjectionInterval(0.5f)
+	, FullLandMovementMode(MOVE_Walking)
+	, FullNavMeshProjectionInterval(0.1f)
+	, SimplifiedMoveInterval(0.0f)
+	, SimplifiedMoveTime(0.0f)
+	, SimplifiedMeshOffset(FVector::ZeroVector)
+	, bSimplifiedMovement(false)
+	, bEaseSimplifiedMesh(false)
+{
+}
+
+void URPGCharacterMovementComponent::SetSimplifiedMovement(bool bSimplified, float MoveInterval)
+{
+	// Clients only see replicated movement for AI, switching modes there would be overwritten
+	bSimplified = bSimplified && CharacterOwner && CharacterOwner->HasAuthority();
+
+	SimplifiedMoveInterval = MoveInterval;
+
+	// Easing needs a visual update every frame, the simulation still only runs every interval
+	const bool bEaseMesh = bSimplified && MoveInterval > 0.0f && GetNetMode() != NM_DedicatedServer;
+	SetComponentTickInterval(bEaseMesh ? 0.0f : MoveInterval);
+
+	if (bEaseSimplifiedMesh && !bEaseMesh)
+	{
+		ResetSimplifiedMeshOffset();
+	}
+	bEaseSimplifiedMesh = bEaseMesh;
+
+	if (bSimplified == bSimplifiedMovement)
+	{
+		return;
+	}
+	bSimplifiedMovement = bSimplified;
+
+	if (bSimplified)
+	{
+		INC_DWORD_STAT(STAT_RPG_SimplifiedMovers);
+
+		FullLandMovementMode = DefaultLandMovementMode;
+		FullNavMeshProjectionInterval = NavMeshProjectionInterval;
+
+		// Nav walking falls back to walking by itself if there is no navmesh under the character
+		DefaultLandMovementMode = MOVE_NavWalking;
+		NavMeshProjectionInterval = SimplifiedNavMeshProjectionInterval;
+		if (MovementMode == MOVE_Walking)
+		{
+			SetMovementMode(MOVE_NavWalking);
+		}
+	}
+	else
+	{
+		DEC_DWORD_STAT(STAT_RPG_SimplifiedMovers);
+
+		DefaultLandMovementMode = FullLandMovementMode;
+		NavMeshProjectionInterval = FullNavMeshProjectionInterval;
+
+		// Finds a spot where the capsule fits, and keeps retrying each tick if there isn't one yet
+		if (MovementMode == MOVE_NavWalking && FullLandMovementMode != MOVE_NavWalking)
+		{
+			TryToLeaveNavWalking();
+		}
+	}
+}
+
+void URPGCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	if (!bEaseSimplifiedMesh || !UpdatedComponent || !CharacterOwner || !CharacterOwner->GetMesh())
+	{
+		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+		return;
+	}
+
+	SimplifiedMoveTime += DeltaTime;
+	if (SimplifiedMoveTime >= SimplifiedMoveInterval)
+	{
+		// The step covers all the time since the last one, and the mesh starts from where it was drawn
+		const FVector DrawnLocation = UpdatedComponent->GetComponentLocation() + SimplifiedMeshOffset * (1.0f - FMath::Min((SimplifiedMoveTime - DeltaTime) / SimplifiedMoveInterval, 1.0f));
+		Super::TickComponent(SimplifiedMoveTime, TickType, ThisTickFunction);
+
+		SimplifiedMoveTime = 0.0f;
+		SimplifiedMeshOffset = DrawnLocation - UpdatedComponent->GetComponentLocation();
+		if (SimplifiedMeshOffset.SizeSquared() > FMath::Square(MaxSimplifiedMeshOffset))
+		{
+			SimplifiedMeshOffset = FVector::ZeroVector;
+		}
+	}
+
+	const FVector MeshOffset = SimplifiedMeshOffset * (1.0f - FMath::Min(SimplifiedMoveTime / SimplifiedMoveInterval, 1.0f));
+	const FVector RelativeOffset = UpdatedComponent->GetComponentQuat().UnrotateVector(MeshOffset);
+	CharacterOwner->GetMesh()->SetRelativeLocation(CharacterOwner->GetBaseTranslationOffset() + RelativeOffset);
+}
+
+void URPGCharacterMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bSimplifiedMovement)
+	{
+		DEC_DWORD_STAT(STAT_RPG_SimplifiedMovers);
+		bSimplifiedMovement = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void URPGCharacterMovementComponent::ResetSimplifiedMeshOffset()
+{
+	SimplifiedMoveTime = 0.0f;
+	SimplifiedMeshOffset = FVector::ZeroVector;
+
+	if (CharacterOwner && CharacterOwner->GetMesh())
+	{
+		CharacterOwner->GetMesh()->SetRelativeLocation(CharacterOwner->GetBaseTranslationOffset());
+	}
+}
@@ -3,14 +3,44 @@
 #include "RPGGameInstanceBase.h"
 #include "RPGAssetManager.h"
 #include "RPGSaveGame.h"
+#include "RPGBootProfile.h"
 #include "Items/RPGItem.h"
 #include "Kismet/GameplayStatics.h"
 
 URPGGameInstanceBase::URPGGameInstanceBase()
 	: SaveSlot(TEXT("SaveGame"))
 	, SaveUserIndex(0)
+	, bUseSaveJournal(true)
+	, SaveJournalCompactionThreshold(256)
+	, bUseSaveService(true)
+	, bUseMappedSaveReader(true)
+	, bSaveSnapshotOnDisk(false)
 {}
 
+void URPGGameInstanceBase::Init()
+{
+	Super::Init();
+
+	// Without its thread the service still writes the same files, only on the game thread
+	SaveService = MakeUnique<FRPGSaveService>();
+	if (bUseSaveService && !SaveService->Start())
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("Failed to start the save service thread, saving on the game thread instead"));
+	}
+}
+
+void URPGGameInstanceBase::Shutdown()
+{
+	if (SaveService)
+	{
+		// Waits for queued writes so quitting right after a save does not lose it
+		SaveService->Shutdown();
+		SaveService.Reset();
+	}
+
+	Super::Shutdown();
+}
+
 void URPGGameInstanceBase::AddDefaultInventory(URPGSaveGame* SaveGame, bool bRemoveExtra)
 {
 	// If we want to remove extra, clear out the existing inventory
@@ -55,11 +85,41 @@ void URPGGameInstanceBase::SetSavingEnabled(bool bEnabled)
 
 bool URPGGameInstanceBase::LoadOrCreateSaveGame()
 {
+	RPG_BOOT_PHASE_SCOPE(TEXT("LoadOrCreateSaveGame"));
+
 	URPGSaveGame* LoadedSave = nullptr;
 
-	if (UGameplayStatics::DoesSaveGameExist(SaveSlot, SaveUserIndex) && bSavingEnabled)
+	if (bUseMappedSaveReader && bSavingEnabled)
 	{
-		LoadedSave = Cast<URPGSaveGame>(UGameplayStatics::LoadGameFromSlot(SaveSlot, SaveUserIndex));
+		// Only the slots are decoded now, the items follow from a worker thread
+		TSharedRef<FRPGSaveGameReader, ESPMode::ThreadSafe> Reader = MakeShared<FRPGSaveGameReader, ESPMode::ThreadSafe>();
+		const FString SaveFilename = FRPGSaveService::FindSaveFileToLoad(SaveSlot, SaveUserIndex);
+		if (!SaveFilename.IsEmpty() && Reader->Open(SaveFilename))
+		{
+			LoadedSave = Reader->LoadSaveGame();
+			if (LoadedSave)
+			{
+				PendingSaveReader = Reader;
+				PendingItemsSaveGame = LoadedSave;
+
+				TWeakObjectPtr<URPGGameInstanceBase> WeakThis(this);
+				Reader->DecodeInventoryItemsAsync(LoadedSave, [WeakThis, Reader, WeakSave = TWeakObjectPtr<URPGSaveGame>(LoadedSave)](bool bSuccess)
+				{
+					URPGGameInstanceBase* GameInstance = WeakThis.Get();
+					if (GameInstance && GameInstance->PendingSaveReader == Reader)
+					{
+						GameInstance->HandleSaveGameItemsDecoded(WeakSave.Get(), bSuccess);
+					}
+				});
+
+				return HandleSaveGameLoaded(LoadedSave);
+			}
+		}
+	}
+
+	if (bSavingEnabled)
+	{
+		LoadedSave = Cast<URPGSaveGame>(FRPGSaveService::LoadGame(SaveSlot, SaveUserIndex));
 	}
 
 	return HandleSaveGameLoaded(LoadedSave);
@@ -78,8 +138,29 @@ bool URPGGameInstanceBase::HandleSaveGameLoaded(USaveGame* SaveGameObject)
 	// Replace current save, old object will GC out
 	CurrentSaveGame = Cast<URPGSaveGame>(SaveGameObject);
 
-	if (CurrentSaveGame)
+	if (CurrentSaveGame != PendingItemsSaveGame.Get())
+	{
+		// Another save replaced the one that was still decoding
+		PendingSaveReader.Reset();
+		PendingItemsSaveGame.Reset();
+	}
+
+	if (CurrentSaveGame && IsSaveGameInventoryPending())
+	{
+		// Only the slots are in, the journal and default inventory are applied once the items are
+		bSaveSnapshotOnDisk = true;
+		bLoaded = true;
+	}
+	else if (CurrentSaveGame)
 	{
+		if (bUseSaveJournal)
+		{
+			// Apply changes written after the snapshot, this also recovers them after a crash
+			const int32 ReplayedRecords = SaveJournal.Replay(GetSaveJournalFilename(), CurrentSaveGame);
+			UE_CLOG(ReplayedRecords > 0, LogActionRPG, Log, TEXT("Replayed %d save journal records"), ReplayedRecords);
+		}
+		bSaveSnapshotOnDisk = true;
+
 		// Make sure it has any newly added default inventory
 		AddDefaultInventory(CurrentSaveGame, false);
 		bLoaded = true;
@@ -90,6 +171,10 @@ bool URPGGameInstanceBase::HandleSaveGameLoaded(USaveGame* SaveGameObject)
 		CurrentSaveGame = Cast<URPGSaveGame>(UGameplayStatics::CreateSaveGameObject(URPGSaveGame::StaticClass()));
 
 		AddDefaultInventory(CurrentSaveGame, true);
+
+		// Nothing on disk matches this save yet, the first write has to be a full one
+		SaveJournal.Discard();
+		bSaveSnapshotOnDisk = false;
 	}
 
 	OnSaveGameLoaded.Broadcast(CurrentSaveGame);
@@ -104,10 +189,55 @@ void URPGGameInstanceBase::GetSaveSlotInfo(FString& SlotName, int32& UserIndex)
 	UserIndex = SaveUserIndex;
 }
 
+void URPGGameInstanceBase::HandleSaveGameItemsDecoded(URPGSaveGame* SaveGame, bool bSuccess)
+{
+	PendingSaveReader.Reset();
+	PendingItemsSaveGame.Reset();
+
+	if (!SaveGame || SaveGame != CurrentSaveGame)
+	{
+		return;
+	}
+
+	if (!bSuccess)
+	{
+		// The items can't be trusted, try a full load of the file
+		UE_LOG(LogActionRPG, Warning, TEXT("Failed to decode save game items, loading the whole save instead"));
+		USaveGame* FullSaveGame = FRPGSaveService::LoadGame(SaveSlot, SaveUserIndex);
+		if (!FullSaveGame)
+		{
+			// Keep the slots that were read, replacing the whole save with a new one would throw away everything else in it too
+			UE_LOG(LogActionRPG, Error, TEXT("Failed to load the whole save, continuing without its items"));
+			FullSaveGame = SaveGame;
+		}
+		HandleSaveGameLoaded(FullSaveGame);
+	}
+	else
+	{
+		// Finishes the load with the journal and default inventory, and lets listeners reload the full inventory
+		HandleSaveGameLoaded(SaveGame);
+	}
+
+	if (bPendingSaveRequested && !bCurrentlySaving)
+	{
+		// A save was requested while the items were missing
+		bPendingSaveRequested = false;
+		WriteSaveGame();
+	}
+}
+
 bool URPGGameInstanceBase::WriteSaveGame()
 {
-	if (bSavingEnabled)
+	// The service is gone after Shutdown
+	if (bSavingEnabled && SaveService)
 	{
+		if (IsSaveGameInventoryPending())
+		{
+			// Writing now would drop the items that are still being decoded
+			bPendingSaveRequested = true;
+			return true;
+		}
+
 		if (bCurrentlySaving)
 		{
 			// Schedule another save to happen after current one finishes. We only queue one save
@@ -118,17 +248,88 @@ bool URPGGameInstanceBase::WriteSaveGame()
 		// Indicate that we're currently doing an async save
 		bCurrentlySaving = true;
 
-		// This goes off in the background
-		UGameplayStatics::AsyncSaveGameToSlot(GetCurrentSaveGame(), SaveSlot, SaveUserIndex, FAsyncSaveGameToSlotDelegate::CreateUObject(this, &URPGGameInstanceBase::HandleAsyncSave));
+		if (bUseSaveJournal)
+		{
+			// The snapshot contains every recorded change, the journal restarts once it is on disk
+			CurrentSaveGame->JournalGeneration++;
+			SaveJournal.ClearPendingRecords();
+		}
+
+		// This goes off in the background, the result always comes back on a later frame
+		TWeakObjectPtr<URPGGameInstanceBase> WeakThis(this);
+		SaveService->SaveGameAsync(GetCurrentSaveGame(), SaveSlot, SaveUserIndex).Next([WeakThis, SlotName = SaveSlot, UserIndex = SaveUserIndex](bool bSuccess)
+		{
+			if (URPGGameInstanceBase* GameInstance = WeakThis.Get())
+			{
+				GameInstance->HandleAsyncSave(SlotName, UserIndex, bSuccess);
+			}
+		});
 		return true;
 	}
 	return false;
 }
 
+bool URPGGameInstanceBase::WriteSaveGameDelta()
+{
+	if (!bSavingEnabled)
+	{
+		return false;
+	}
+
+	if (!bUseSaveJournal)
+	{
+		return WriteSaveGame();
+	}
+
+	if (bCurrentlySaving || IsSaveGameInventoryPending())
+	{
+		// Records stay queued and are appended to the new journal when the snapshot finishes
+		return true;
+	}
+
+	if (bSaveSnapshotOnDisk && SaveJournal.IsOpen() && SaveJournal.GetRecordCount() < SaveJournalCompactionThreshold)
+	{
+		if (SaveJournal.Flush())
+		{
+			return true;
+		}
+	}
+
+	// Compact, this writes the full snapshot and starts an empty journal
+	return WriteSaveGame();
+}
+
+void URPGGameInstanceBase::RecordInventoryItemChange(const FPrimaryAssetId& ItemId, const FRPGItemData& ItemData)
+{
+	if (bUseSaveJournal)
+	{
+		SaveJournal.RecordItem(ItemId, ItemData);
+	}
+}
+
+void URPGGameInstanceBase::RecordSlottedItemChange(const FRPGItemSlot& ItemSlot, const FPrimaryAssetId& ItemId)
+{
+	if (bUseSaveJournal)
+	{
+		SaveJournal.RecordSlot(ItemSlot, ItemId);
+	}
+}
+
+FString URPGGameInstanceBase::GetSaveJournalFilename() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("SaveGames") / FString::Printf(TEXT("%s_%d.journal"), *SaveSlot, SaveUserIndex);
+}
+
 void URPGGameInstanceBase::ResetSaveGame()
 {
 	// Call handle function with no loaded save, this will reset the data
 	HandleSaveGameLoaded(nullptr);
+
+	if (bUseSaveJournal && bSavingEnabled)
+	{
+		// The new save starts at generation 0 again, an old journal could match it and be replayed after a crash
+		SaveJournal.Delete(GetSaveJournalFilename());
+	}
 }
 
 void URPGGameInstanceBase::HandleAsyncSave(const FString& SlotName, const int32 UserIndex, bool bSuccess)
@@ -136,6 +337,22 @@ void URPGGameInstanceBase::HandleAsyncSave(const FString& SlotName, const int32
 	ensure(bCurrentlySaving);
 	bCurrentlySaving = false;
 
+	if (bUseSaveJournal)
+	{
+		if (bSuccess)
+		{
+			// The old journal is part of the new snapshot, start over and append anything recorded during the save
+			bSaveSnapshotOnDisk = true;
+			SaveJournal.Reset(GetSaveJournalFilename(), CurrentSaveGame->JournalGeneration);
+			SaveJournal.Flush();
+		}
+		else
+		{
+			// Changes cleared from the journal for this snapshot were not written, so the next write has to be a full one
+			bSaveSnapshotOnDisk = false;
+		}
+	}
+
 	if (bPendingSaveRequested)
 	{
 		// Start another save as we got a request while saving
@@ -1,6 +1,8 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "RPGHomingProjectile.h"
+#include "RPGBenchmark.h"
+#include "RPGStats.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
@@ -55,9 +57,45 @@ ARPGHomingProjectile::ARPGHomingProjectile()
 void ARPGHomingProjectile::BeginPlay()
 {
 	Super::BeginPlay();
+	RPGStats::RecordProjectileSpawned();
 	
 	// Set lifespan
 	SetLifeSpan(ProjectileLifespan);
+
+	if (URPGSignificanceSubsystem* Significance = URPGSignificanceSubsystem::Get(this))
+	{
+		Significance->RegisterActor(this, FOnSignificanceTierChanged::CreateUObject(this, &ARPGHomingProjectile::ApplySignificanceTier));
+	}
+}
+
+void ARPGHomingProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	RPGStats::RecordProjectileDestroyed();
+
+	if (URPGSignificanceSubsystem* Significance = URPGSignificanceSubsystem::Get(this))
+	{
+		Significance->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ARPGHomingProjectile::ApplySignificanceTier(ERPGSignificanceTier Tier)
+{
+	if (!ParticleComponent)
+	{
+		return;
+	}
+
+	const bool bSpawnEffects = URPGSignificanceSubsystem::Get(this)->GetTierSettings(Tier).bSpawnEffects;
+	if (bSpawnEffects && !ParticleComponent->IsActive())
+	{
+		ParticleComponent->Activate();
+	}
+	else if (!bSpawnEffects && ParticleComponent->IsActive())
+	{
+		ParticleComponent->Deactivate();
+	}
 }
 
 void ARPGHomingProjectile::SetHomingTarget(AActor* NewTarget)
@@ -83,6 +121,9 @@ void ARPGHomingProjectile::InitializeProjectile(float BaseDamage, AActor* Damage
 
 void ARPGHomingProjectile::OnProjectileHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	RPG_BENCHMARK_SCOPE(Projectile);
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_ProjectileHit);
+
 	// Don't hit ourselves or our instigator
 	if (OtherActor && OtherActor != this && OtherActor != InstigatorActor)
 	{
@@ -1,10 +1,31 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "RPGPlayerControllerBase.h"
+#include "RPGStats.h"
+#include "RPGBootProfile.h"
 #include "RPGCharacterBase.h"
 #include "RPGGameInstanceBase.h"
 #include "RPGSaveGame.h"
 #include "Items/RPGItem.h"
+#include "Items/RPGInventoryComponent.h"
+#include "Engine/StreamableManager.h"
+#include "ActionRPGLoadingScreen.h"
+
+/** Loading screen task for streaming in the inventory */
+static const FName InventoryLoadTaskName(TEXT("InventoryLoad"));
+
+ARPGPlayerControllerBase::ARPGPlayerControllerBase()
+	: InventorySaveInterval(2.0f)
+	, bInventorySaveDirty(false)
+	, bSaveGameInSync(false)
+	, bInventoryLoadPending(false)
+	, bReplicatedInventorySyncPending(false)
+	, bSaveGameItemsPending(false)
+	, InventoryBatchDepth(0)
+	, AvoidedInventorySaveCount(0)
+{
+	InventoryComponent = CreateDefaultSubobject<URPGInventoryComponent>(TEXT("InventoryComponent"));
+}
 
 bool ARPGPlayerControllerBase::AddInventoryItem(URPGItem* NewItem, int32 ItemCount, int32 ItemLevel, bool bAutoSlot)
 {
@@ -15,12 +36,30 @@ bool ARPGPlayerControllerBase::AddInventoryItem(URPGItem* NewItem, int32 ItemCou
 		return false;
 	}
 
+	if (!HasAuthority())
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("AddInventoryItem: Inventory can only be changed on the server!"));
+		return false;
+	}
+
 	if (ItemCount <= 0 || ItemLevel <= 0)
 	{
 		UE_LOG(LogActionRPG, Warning, TEXT("AddInventoryItem: Failed trying to add item %s with negative count or level!"), *NewItem->GetName());
 		return false;
 	}
 
+	if (IsInventoryChangeDeferred())
+	{
+		// The saved inventory is not in yet, this is added on top of it once it is
+		FRPGDeferredInventoryEdit& Edit = DeferredInventoryEdits.AddDefaulted_GetRef();
+		Edit.EditType = ERPGDeferredInventoryEditType::AddItem;
+		Edit.Item = NewItem;
+		Edit.ItemCount = ItemCount;
+		Edit.ItemLevel = ItemLevel;
+		Edit.bAutoSlot = bAutoSlot;
+		return true;
+	}
+
 	// Find current item data, which may be empty
 	FRPGItemData OldData;
 	GetInventoryItemData(NewItem, OldData);
@@ -32,7 +71,7 @@ bool ARPGPlayerControllerBase::AddInventoryItem(URPGItem* NewItem, int32 ItemCou
 	if (OldData != NewData)
 	{
 		// If data changed, need to update storage and call callback
-		InventoryData.Add(NewItem, NewData);
+		SetInventoryItemData(NewItem, NewData);
 		NotifyInventoryItemChanged(true, NewItem);
 		bChanged = true;
 	}
@@ -46,7 +85,7 @@ bool ARPGPlayerControllerBase::AddInventoryItem(URPGItem* NewItem, int32 ItemCou
 	if (bChanged)
 	{
 		// If anything changed, write to save game
-		SaveInventory();
+		RequestSaveInventory();
 		return true;
 	}
 	return false;
@@ -60,6 +99,22 @@ bool ARPGPlayerControllerBase::RemoveInventoryItem(URPGItem* RemovedItem, int32
 		return false;
 	}
 
+	if (!HasAuthority())
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("RemoveInventoryItem: Inventory can only be changed on the server!"));
+		return false;
+	}
+
+	if (IsInventoryChangeDeferred())
+	{
+		// The saved inventory is not in yet, this is removed from it once it is
+		FRPGDeferredInventoryEdit& Edit = DeferredInventoryEdits.AddDefaulted_GetRef();
+		Edit.EditType = ERPGDeferredInventoryEditType::RemoveItem;
+		Edit.Item = RemovedItem;
+		Edit.ItemCount = RemoveCount;
+		return true;
+	}
+
 	// Find current item data, which may be empty
 	FRPGItemData NewData;
 	GetInventoryItemData(RemovedItem, NewData);
@@ -83,75 +138,143 @@ bool ARPGPlayerControllerBase::RemoveInventoryItem(URPGItem* RemovedItem, int32
 	if (NewData.ItemCount > 0)
 	{
 		// Update data with new count
-		InventoryData.Add(RemovedItem, NewData);
+		SetInventoryItemData(RemovedItem, NewData);
 	}
 	else
 	{
 		// Remove item entirely, make sure it is unslotted
-		InventoryData.Remove(RemovedItem);
+		RemoveInventoryItemData(RemovedItem);
 
-		for (TPair<FRPGItemSlot, URPGItem*>& Pair : SlottedItems)
+		TArray<FRPGItemSlot, TInlineAllocator<4>> RemovedSlots;
+		for (const TPair<FRPGItemSlot, URPGItem*>& Pair : SlottedItems)
 		{
 			if (Pair.Value == RemovedItem)
 			{
-				Pair.Value = nullptr;
-				NotifySlottedItemChanged(Pair.Key, Pair.Value);
+				RemovedSlots.Add(Pair.Key);
 			}
 		}
+
+		for (const FRPGItemSlot& ItemSlot : RemovedSlots)
+		{
+			SetSlotContents(ItemSlot, nullptr);
+			NotifySlottedItemChanged(ItemSlot, nullptr);
+		}
 	}
 
 	// If we got this far, there is a change so notify and save
 	NotifyInventoryItemChanged(false, RemovedItem);
 
-	SaveInventory();
+	RequestSaveInventory();
 	return true;
 }
 
+bool ARPGPlayerControllerBase::AddInventoryItems(const TArray<URPGItem*>& NewItems, int32 ItemCount, int32 ItemLevel, bool bAutoSlot)
+{
+	FRPGInventoryBatch Batch(this);
+
+	bool bChanged = false;
+	for (URPGItem* NewItem : NewItems)
+	{
+		bChanged |= AddInventoryItem(NewItem, ItemCount, ItemLevel, bAutoSlot);
+	}
+	return bChanged;
+}
+
+bool ARPGPlayerControllerBase::RemoveInventoryItems(const TArray<URPGItem*>& RemovedItems, int32 RemoveCount)
+{
+	FRPGInventoryBatch Batch(this);
+
+	bool bChanged = false;
+	for (URPGItem* RemovedItem : RemovedItems)
+	{
+		bChanged |= RemoveInventoryItem(RemovedItem, RemoveCount);
+	}
+	return bChanged;
+}
+
+void ARPGPlayerControllerBase::BeginInventoryBatch()
+{
+	InventoryBatchDepth++;
+}
+
+void ARPGPlayerControllerBase::EndInventoryBatch()
+{
+	if (InventoryBatchDepth <= 0)
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("EndInventoryBatch: Called without a matching BeginInventoryBatch!"));
+		return;
+	}
+
+	InventoryBatchDepth--;
+
+	if (InventoryBatchDepth == 0 && (BatchedItemChanges.Num() > 0 || BatchedSlotChanges.Num() > 0))
+	{
+		NotifyInventoryBatchChanged();
+	}
+}
+
 void ARPGPlayerControllerBase::GetInventoryItems(TArray<URPGItem*>& Items, FPrimaryAssetType ItemType)
 {
 	for (const TPair<URPGItem*, FRPGItemData>& Pair : InventoryData)
 	{
-		if (Pair.Key)
+		// Filters based on the cached item type, no need to build the asset id
+		if (Pair.Key && (Pair.Key->ItemType == ItemType || !ItemType.IsValid()))
 		{
-			FPrimaryAssetId AssetId = Pair.Key->GetPrimaryAssetId();
-
-			// Filters based on item type
-			if (AssetId.PrimaryAssetType == ItemType || !ItemType.IsValid())
-			{
-				Items.Add(Pair.Key);
-			}
-		}	
+			Items.Add(Pair.Key);
+		}
 	}
 }
 
 bool ARPGPlayerControllerBase::SetSlottedItem(FRPGItemSlot ItemSlot, URPGItem* Item)
 {
-	// Iterate entire inventory because we need to remove from old slot
-	bool bFound = false;
-	for (TPair<FRPGItemSlot, URPGItem*>& Pair : SlottedItems)
+	if (!HasAuthority())
 	{
-		if (Pair.Key == ItemSlot)
+		// The change comes back through replication once the server applied it
+		ServerSetSlottedItem(ItemSlot, Item);
+		return true;
+	}
+
+	if (IsInventoryChangeDeferred())
+	{
+		// The saved slots are not in yet, this is applied on top of them once they are
+		FRPGDeferredInventoryEdit& Edit = DeferredInventoryEdits.AddDefaulted_GetRef();
+		Edit.EditType = ERPGDeferredInventoryEditType::SetSlot;
+		Edit.Item = Item;
+		Edit.ItemSlot = ItemSlot;
+		return true;
+	}
+
+	// Every valid slot was added by LoadInventory
+	if (!SlottedItems.Contains(ItemSlot))
+	{
+		return false;
+	}
+
+	if (Item != nullptr)
+	{
+		// If this item was found in another slot, remove it. There are only a few slots so this is cheap
+		TArray<FRPGItemSlot, TInlineAllocator<4>> OldSlots;
+		for (const TPair<FRPGItemSlot, URPGItem*>& Pair : SlottedItems)
 		{
-			// Add to new slot
-			bFound = true;
-			Pair.Value = Item;
-			NotifySlottedItemChanged(Pair.Key, Pair.Value);
+			if (Pair.Value == Item && Pair.Key != ItemSlot)
+			{
+				OldSlots.Add(Pair.Key);
+			}
 		}
-		else if (Item != nullptr && Pair.Value == Item)
+
+		for (const FRPGItemSlot& OldSlot : OldSlots)
 		{
-			// If this item was found in another slot, remove it
-			Pair.Value = nullptr;
-			NotifySlottedItemChanged(Pair.Key, Pair.Value);
+			SetSlotContents(OldSlot, nullptr);
+			NotifySlottedItemChanged(OldSlot, nullptr);
 		}
 	}
 
-	if (bFound)
-	{
-		SaveInventory();
-		return true;
-	}
+	// Add to new slot
+	SetSlotContents(ItemSlot, Item);
+	NotifySlottedItemChanged(ItemSlot, Item);
 
-	return false;
+	RequestSaveInventory();
+	return true;
 }
 
 int32 ARPGPlayerControllerBase::GetInventoryItemCount(URPGItem* Item) const
@@ -178,6 +301,15 @@ bool ARPGPlayerControllerBase::GetInventoryItemData(URPGItem* Item, FRPGItemData
 	return false;
 }
 
+void ARPGPlayerControllerBase::ServerSetSlottedItem_Implementation(FRPGItemSlot ItemSlot, URPGItem* Item)
+{
+	// Clients can only slot items they own
+	if (Item == nullptr || InventoryData.Contains(Item))
+	{
+		SetSlottedItem(ItemSlot, Item);
+	}
+}
+
 URPGItem* ARPGPlayerControllerBase::GetSlottedItem(FRPGItemSlot ItemSlot) const
 {
 	URPGItem* const* FoundItem = SlottedItems.Find(ItemSlot);
@@ -191,7 +323,7 @@ URPGItem* ARPGPlayerControllerBase::GetSlottedItem(FRPGItemSlot ItemSlot) const
 
 void ARPGPlayerControllerBase::GetSlottedItems(TArray<URPGItem*>& Items, FPrimaryAssetType ItemType, bool bOutputEmptyIndexes)
 {
-	for (TPair<FRPGItemSlot, URPGItem*>& Pair : SlottedItems)
+	for (const TPair<FRPGItemSlot, URPGItem*>& Pair : SlottedItems)
 	{
 		if (Pair.Key.ItemType == ItemType || !ItemType.IsValid())
 		{
@@ -210,22 +342,76 @@ void ARPGPlayerControllerBase::FillEmptySlots()
 
 	if (bShouldSave)
 	{
-		SaveInventory();
+		RequestSaveInventory();
 	}
 }
 
 bool ARPGPlayerControllerBase::SaveInventory()
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_SaveInventory);
+
+	if (!HasAuthority())
+	{
+		// Clients get their inventory from the server, which owns the save
+		return false;
+	}
+
+	if (!IsLocalController())
+	{
+		// The game instance holds one save, which belongs to the local player. Remote players must not write over it
+		return false;
+	}
+
 	UWorld* World = GetWorld();
 	URPGGameInstanceBase* GameInstance = World ? World->GetGameInstance<URPGGameInstanceBase>() : nullptr;
 
+	if (IsInventoryChangeDeferred() || (GameInstance && GameInstance->IsSaveGameInventoryPending()))
+	{
+		// The inventory is still loading, saving now would write an incomplete inventory over the save game. Save once it is in
+		bInventorySaveDirty = true;
+		GetWorldTimerManager().ClearTimer(InventorySaveTimerHandle);
+		return false;
+	}
+
+	// Any pending request is handled by this save
+	bInventorySaveDirty = false;
+	GetWorldTimerManager().ClearTimer(InventorySaveTimerHandle);
+
 	if (!GameInstance)
 	{
 		return false;
 	}
 
 	URPGSaveGame* CurrentSaveGame = GameInstance->GetCurrentSaveGame();
-	if (CurrentSaveGame)
+	if (CurrentSaveGame && bSaveGameInSync)
+	{
+		// Only apply what changed, and let the game instance append just those changes to the save journal
+		for (const TPair<FPrimaryAssetId, FRPGItemData>& ItemPair : PendingItemChanges)
+		{
+			if (ItemPair.Value.IsValid())
+			{
+				CurrentSaveGame->InventoryData.Add(ItemPair.Key, ItemPair.Value);
+			}
+			else
+			{
+				CurrentSaveGame->InventoryData.Remove(ItemPair.Key);
+			}
+			GameInstance->RecordInventoryItemChange(ItemPair.Key, ItemPair.Value);
+		}
+
+		for (const TPair<FRPGItemSlot, FPrimaryAssetId>& SlotPair : PendingSlotChanges)
+		{
+			CurrentSaveGame->SlottedItems.Add(SlotPair.Key, SlotPair.Value);
+			GameInstance->RecordSlottedItemChange(SlotPair.Key, SlotPair.Value);
+		}
+
+		PendingItemChanges.Reset();
+		PendingSlotChanges.Reset();
+
+		GameInstance->WriteSaveGameDelta();
+		return true;
+	}
+	else if (CurrentSaveGame)
 	{
 		// Reset cached data in save game before writing to it
 		CurrentSaveGame->InventoryData.Reset();
@@ -253,6 +439,10 @@ bool ARPGPlayerControllerBase::SaveInventory()
 			CurrentSaveGame->SlottedItems.Add(SlotPair.Key, AssetId);
 		}
 
+		PendingItemChanges.Reset();
+		PendingSlotChanges.Reset();
+		bSaveGameInSync = true;
+
 		// Now that cache is updated, write to disk
 		GameInstance->WriteSaveGame();
 		return true;
@@ -260,22 +450,119 @@ bool ARPGPlayerControllerBase::SaveInventory()
 	return false;
 }
 
+void ARPGPlayerControllerBase::RequestSaveInventory()
+{
+	if (!HasAuthority() || !IsLocalController())
+	{
+		return;
+	}
+
+	if (InventorySaveInterval <= 0.0f)
+	{
+		SaveInventory();
+		return;
+	}
+
+	if (bInventorySaveDirty)
+	{
+		// A save is already scheduled and will pick up this change
+		AvoidedInventorySaveCount++;
+		INC_DWORD_STAT(STAT_RPG_AvoidedSaves);
+		return;
+	}
+
+	bInventorySaveDirty = true;
+	GetWorldTimerManager().SetTimer(InventorySaveTimerHandle, this, &ARPGPlayerControllerBase::HandleInventorySaveTimer, InventorySaveInterval, false);
+}
+
+bool ARPGPlayerControllerBase::FlushInventorySave()
+{
+	if (bInventorySaveDirty)
+	{
+		return SaveInventory();
+	}
+	return false;
+}
+
+void ARPGPlayerControllerBase::HandleInventorySaveTimer()
+{
+	FlushInventorySave();
+}
+
 bool ARPGPlayerControllerBase::LoadInventory()
 {
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_LoadInventory);
+
+	if (IsLocalController())
+	{
+		// Ends in NotifyInventoryLoaded, which may be after the item loads stream in
+		RPGBoot::BeginPhase(TEXT("LoadInventory"));
+	}
+
 	InventoryData.Reset();
 	SlottedItems.Reset();
 
+	if (ShouldReplicateInventory())
+	{
+		// Clients keep what they have until the reload is done, most of it is usually unchanged
+		bReplicatedInventorySyncPending = true;
+	}
+
+	// A save held back by a load that is being replaced still has to happen once the new load is in
+	const bool bSaveDeferred = bInventorySaveDirty && IsInventoryChangeDeferred();
+	bSaveGameItemsPending = false;
+
+	// A newer load replaces any that is still streaming
+	if (bInventoryLoadPending && IsLocalController() && IActionRPGLoadingScreenModule::IsAvailable())
+	{
+		IActionRPGLoadingScreenModule::Get().EndLoadingTask(InventoryLoadTaskName);
+	}
+	bInventoryLoadPending = false;
+	if (InventoryLoadHandle.IsValid())
+	{
+		InventoryLoadHandle->CancelHandle();
+		InventoryLoadHandle.Reset();
+	}
+
+	// Anything pending was for the inventory we are replacing
+	bInventorySaveDirty = false;
+	bSaveGameInSync = false;
+	PendingItemChanges.Reset();
+	PendingSlotChanges.Reset();
+	GetWorldTimerManager().ClearTimer(InventorySaveTimerHandle);
+
 	// Fill in slots from game instance
 	UWorld* World = GetWorld();
 	URPGGameInstanceBase* GameInstance = World ? World->GetGameInstance<URPGGameInstanceBase>() : nullptr;
 
 	if (!GameInstance)
 	{
+		FinishReplicatedInventorySync();
+		return false;
+	}
+
+	if (!HasAuthority())
+	{
+		// Clients don't read the local save, the inventory is whatever the server replicated so far
+		for (const TPair<FPrimaryAssetType, int32>& Pair : GameInstance->ItemSlotsPerType)
+		{
+			for (int32 SlotNumber = 0; SlotNumber < Pair.Value; SlotNumber++)
+			{
+				SetSlotContents(FRPGItemSlot(Pair.Key, SlotNumber), nullptr);
+			}
+		}
+
+		if (InventoryComponent)
+		{
+			InventoryComponent->ApplyReplicatedInventory();
+		}
+
+		NotifyInventoryLoaded();
 		return false;
 	}
 
-	// Bind to loaded callback if not already bound
-	if (!GameInstance->OnSaveGameLoadedNative.IsBoundToObject(this))
+	// Bind to loaded callback if not already bound, only the local player's inventory comes from the game instance's save
+	if (IsLocalController() && !GameInstance->OnSaveGameLoadedNative.IsBoundToObject(this))
 	{
 		GameInstance->OnSaveGameLoadedNative.AddUObject(this, &ARPGPlayerControllerBase::HandleSaveGameLoaded);
 	}
@@ -284,23 +571,119 @@ bool ARPGPlayerControllerBase::LoadInventory()
 	{
 		for (int32 SlotNumber = 0; SlotNumber < Pair.Value; SlotNumber++)
 		{
-			SlottedItems.Add(FRPGItemSlot(Pair.Key, SlotNumber), nullptr);
+			SetSlotContents(FRPGItemSlot(Pair.Key, SlotNumber), nullptr);
 		}
 	}
 
-	URPGSaveGame* CurrentSaveGame = GameInstance->GetCurrentSaveGame();
-	URPGAssetManager& AssetManager = URPGAssetManager::Get();
+	// Remote players on a listen or dedicated server start empty, they are not saved
+	URPGSaveGame* CurrentSaveGame = IsLocalController() ? GameInstance->GetCurrentSaveGame() : nullptr;
 	if (CurrentSaveGame)
 	{
-		// Copy from save game into controller data
+		// Gather every item the save refers to and stream them in as one batch instead of loading them one at a time
+		TSet<FPrimaryAssetId> ItemIdSet;
+		for (const TPair<FPrimaryAssetId, FRPGItemData>& ItemPair : CurrentSaveGame->InventoryData)
+		{
+			ItemIdSet.Add(ItemPair.Key);
+		}
+		for (const TPair<FRPGItemSlot, FPrimaryAssetId>& SlotPair : CurrentSaveGame->SlottedItems)
+		{
+			if (SlotPair.Value.IsValid())
+			{
+				ItemIdSet.Add(SlotPair.Value);
+			}
+		}
+
+		bInventoryLoadPending = true;
+		bInventorySaveDirty = bSaveDeferred;
+		InventoryLoadHandle = URPGAssetManager::Get().LoadPrimaryAssets(ItemIdSet.Array(), TArray<FName>(), FStreamableDelegate::CreateUObject(this, &ARPGPlayerControllerBase::HandleInventoryAssetsLoaded), FStreamableManager::AsyncLoadHighPriority);
+
+		if (InventoryLoadHandle.IsValid() && !InventoryLoadHandle->HasLoadCompleted())
+		{
+			InventoryLoadHandle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateUObject(this, &ARPGPlayerControllerBase::HandleInventoryLoadUpdate));
+			NotifyInventoryLoadProgress(0.0f);
+		}
+		else
+		{
+			// Everything was already in memory, finish now instead of waiting for the deferred callback
+			HandleInventoryAssetsLoaded();
+		}
+
+		return true;
+	}
+
+	// Load failed but we reset inventory, so need to notify UI
+	NotifyInventoryLoaded();
+
+	return false;
+}
+
+void ARPGPlayerControllerBase::HandleInventoryLoadUpdate(TSharedRef<FStreamableHandle> Handle)
+{
+	if (bInventoryLoadPending && Handle == InventoryLoadHandle)
+	{
+		NotifyInventoryLoadProgress(Handle->GetProgress());
+	}
+}
+
+void ARPGPlayerControllerBase::HandleInventoryAssetsLoaded()
+{
+	if (!bInventoryLoadPending)
+	{
+		// Already handled, or replaced by a newer load
+		return;
+	}
+	bInventoryLoadPending = false;
+
+	// A save requested during the load was held back, it has to be scheduled again
+	const bool bSaveDeferred = bInventorySaveDirty;
+	bInventorySaveDirty = false;
+
+	UWorld* World = GetWorld();
+	URPGGameInstanceBase* GameInstance = World ? World->GetGameInstance<URPGGameInstanceBase>() : nullptr;
+	URPGSaveGame* CurrentSaveGame = GameInstance ? GameInstance->GetCurrentSaveGame() : nullptr;
+
+	if (CurrentSaveGame && GameInstance->IsSaveGameInventoryPending())
+	{
+		// Only the slots of the save are decoded so far. Show them, but keep holding back changes and saves until the game
+		// instance broadcasts the full save and LoadInventory runs again
+		bSaveGameItemsPending = true;
+		bInventorySaveDirty = bSaveDeferred;
+
+		URPGAssetManager& AssetManager = URPGAssetManager::Get();
+		for (const TPair<FRPGItemSlot, FPrimaryAssetId>& SlotPair : CurrentSaveGame->SlottedItems)
+		{
+			URPGItem* LoadedItem = SlotPair.Value.IsValid() ? AssetManager.FindLoadedItem(SlotPair.Value) : nullptr;
+			if (GameInstance->IsValidItemSlot(SlotPair.Key) && LoadedItem)
+			{
+				SetSlotContents(SlotPair.Key, LoadedItem);
+			}
+		}
+
+		NotifyInventoryLoadProgress(1.0f);
+		NotifyInventoryLoaded();
+		return;
+	}
+
+	if (CurrentSaveGame)
+	{
+		// Changes from here on can be applied to the save game as deltas
+		bSaveGameInSync = true;
+
+		URPGAssetManager& AssetManager = URPGAssetManager::Get();
+
+		// Copy from save game into controller data, all items are in memory now
 		bool bFoundAnySlots = false;
 		for (const TPair<FPrimaryAssetId, FRPGItemData>& ItemPair : CurrentSaveGame->InventoryData)
 		{
-			URPGItem* LoadedItem = AssetManager.ForceLoadItem(ItemPair.Key);
+			URPGItem* LoadedItem = AssetManager.FindLoadedItem(ItemPair.Key);
 
 			if (LoadedItem != nullptr)
 			{
-				InventoryData.Add(LoadedItem, ItemPair.Value);
+				SetInventoryItemData(LoadedItem, ItemPair.Value);
+			}
+			else
+			{
+				UE_LOG(LogActionRPG, Warning, TEXT("Failed to load item for identifier %s!"), *ItemPair.Key.ToString());
 			}
 		}
 
@@ -308,10 +691,10 @@ bool ARPGPlayerControllerBase::LoadInventory()
 		{
 			if (SlotPair.Value.IsValid())
 			{
-				URPGItem* LoadedItem = AssetManager.ForceLoadItem(SlotPair.Value);
+				URPGItem* LoadedItem = AssetManager.FindLoadedItem(SlotPair.Value);
 				if (GameInstance->IsValidItemSlot(SlotPair.Key) && LoadedItem)
 				{
-					SlottedItems.Add(SlotPair.Key, LoadedItem);
+					SetSlotContents(SlotPair.Key, LoadedItem);
 					bFoundAnySlots = true;
 				}
 			}
@@ -322,16 +705,46 @@ bool ARPGPlayerControllerBase::LoadInventory()
 			// Auto slot items as no slots were saved
 			FillEmptySlots();
 		}
+	}
 
-		NotifyInventoryLoaded();
+	ApplyDeferredInventoryEdits();
 
-		return true;
+	if (bSaveDeferred)
+	{
+		RequestSaveInventory();
 	}
 
-	// Load failed but we reset inventory, so need to notify UI
+	NotifyInventoryLoadProgress(1.0f);
 	NotifyInventoryLoaded();
+}
 
-	return false;
+void ARPGPlayerControllerBase::ApplyDeferredInventoryEdits()
+{
+	if (DeferredInventoryEdits.Num() == 0)
+	{
+		return;
+	}
+
+	// Move out first, the edits are applied through the normal functions which save and notify as usual
+	const TArray<FRPGDeferredInventoryEdit> Edits = MoveTemp(DeferredInventoryEdits);
+	DeferredInventoryEdits.Reset();
+
+	FRPGInventoryBatch Batch(this);
+	for (const FRPGDeferredInventoryEdit& Edit : Edits)
+	{
+		switch (Edit.EditType)
+		{
+		case ERPGDeferredInventoryEditType::AddItem:
+			AddInventoryItem(Edit.Item, Edit.ItemCount, Edit.ItemLevel, Edit.bAutoSlot);
+			break;
+		case ERPGDeferredInventoryEditType::RemoveItem:
+			RemoveInventoryItem(Edit.Item, Edit.ItemCount);
+			break;
+		case ERPGDeferredInventoryEditType::SetSlot:
+			SetSlottedItem(Edit.ItemSlot, Edit.Item);
+			break;
+		}
+	}
 }
 
 bool ARPGPlayerControllerBase::FillEmptySlotWithItem(URPGItem* NewItem)
@@ -358,7 +771,7 @@ bool ARPGPlayerControllerBase::FillEmptySlotWithItem(URPGItem* NewItem)
 
 	if (EmptySlot.IsValid())
 	{
-		SlottedItems[EmptySlot] = NewItem;
+		SetSlotContents(EmptySlot, NewItem);
 		NotifySlottedItemChanged(EmptySlot, NewItem);
 		return true;
 	}
@@ -366,8 +779,104 @@ bool ARPGPlayerControllerBase::FillEmptySlotWithItem(URPGItem* NewItem)
 	return false;
 }
 
+bool ARPGPlayerControllerBase::ShouldReplicateInventory() const
+{
+	return InventoryComponent && HasAuthority() && GetNetMode() != NM_Standalone && !bReplicatedInventorySyncPending;
+}
+
+void ARPGPlayerControllerBase::FinishReplicatedInventorySync()
+{
+	if (!bReplicatedInventorySyncPending)
+	{
+		return;
+	}
+	bReplicatedInventorySyncPending = false;
+
+	if (ShouldReplicateInventory())
+	{
+		InventoryComponent->SyncReplicatedInventory(InventoryData, SlottedItems);
+	}
+}
+
+void ARPGPlayerControllerBase::SetInventoryItemData(URPGItem* Item, const FRPGItemData& ItemData)
+{
+	InventoryData.Add(Item, ItemData);
+
+	if (ShouldReplicateInventory())
+	{
+		InventoryComponent->SetReplicatedItem(Item, ItemData);
+	}
+}
+
+void ARPGPlayerControllerBase::RemoveInventoryItemData(URPGItem* Item)
+{
+	if (InventoryData.Remove(Item) > 0)
+	{
+		if (ShouldReplicateInventory())
+		{
+			InventoryComponent->SetReplicatedItem(Item, FRPGItemData(0, 0));
+		}
+	}
+}
+
+void ARPGPlayerControllerBase::SetSlotContents(const FRPGItemSlot& ItemSlot, URPGItem* Item)
+{
+	SlottedItems.Add(ItemSlot, Item);
+
+	if (ShouldReplicateInventory())
+	{
+		InventoryComponent->SetReplicatedSlot(ItemSlot, Item);
+	}
+}
+
+void ARPGPlayerControllerBase::ApplyReplicatedItem(URPGItem* Item, const FRPGItemData& ItemData)
+{
+	if (ItemData.IsValid())
+	{
+		const bool bAdded = !InventoryData.Contains(Item) || InventoryData[Item].ItemCount < ItemData.ItemCount;
+		SetInventoryItemData(Item, ItemData);
+		NotifyInventoryItemChanged(bAdded, Item);
+	}
+	else if (InventoryData.Contains(Item))
+	{
+		RemoveInventoryItemData(Item);
+		NotifyInventoryItemChanged(false, Item);
+	}
+}
+
+void ARPGPlayerControllerBase::ApplyReplicatedSlot(const FRPGItemSlot& ItemSlot, URPGItem* Item)
+{
+	if (GetSlottedItem(ItemSlot) != Item || !SlottedItems.Contains(ItemSlot))
+	{
+		SetSlotContents(ItemSlot, Item);
+		NotifySlottedItemChanged(ItemSlot, Item);
+	}
+}
+
 void ARPGPlayerControllerBase::NotifyInventoryItemChanged(bool bAdded, URPGItem* Item)
 {
+	if (Item && HasAuthority())
+	{
+		// Remember the final state for the next save, removed items are saved as invalid data
+		const FRPGItemData* FoundData = InventoryData.Find(Item);
+		PendingItemChanges.Add(Item->GetPrimaryAssetId(), FoundData ? *FoundData : FRPGItemData(0, 0));
+	}
+
+	if (InventoryBatchDepth > 0)
+	{
+		// Sent once when the batch ends
+		const int32 BatchIndex = BatchedItemChanges.AddUnique(Item);
+		if (BatchIndex == BatchedItemAdded.Num())
+		{
+			BatchedItemAdded.Add(bAdded);
+		}
+		else
+		{
+			BatchedItemAdded[BatchIndex] = bAdded;
+		}
+		return;
+	}
+
 	// Notify native before blueprint
 	OnInventoryItemChangedNative.Broadcast(bAdded, Item);
 	OnInventoryItemChanged.Broadcast(bAdded, Item);
@@ -378,6 +887,18 @@ void ARPGPlayerControllerBase::NotifyInventoryItemChanged(bool bAdded, URPGItem*
 
 void ARPGPlayerControllerBase::NotifySlottedItemChanged(FRPGItemSlot ItemSlot, URPGItem* Item)
 {
+	if (HasAuthority())
+	{
+		PendingSlotChanges.Add(ItemSlot, Item ? Item->GetPrimaryAssetId() : FPrimaryAssetId());
+	}
+
+	if (InventoryBatchDepth > 0)
+	{
+		// Sent once when the batch ends, listeners read the current slot contents
+		BatchedSlotChanges.AddUnique(ItemSlot);
+		return;
+	}
+
 	// Notify native before blueprint
 	OnSlottedItemChangedNative.Broadcast(ItemSlot, Item);
 	OnSlottedItemChanged.Broadcast(ItemSlot, Item);
@@ -386,13 +907,74 @@ void ARPGPlayerControllerBase::NotifySlottedItemChanged(FRPGItemSlot ItemSlot, U
 	SlottedItemChanged(ItemSlot, Item);
 }
 
+void ARPGPlayerControllerBase::NotifyInventoryBatchChanged()
+{
+	// Move out first so listeners can start a new batch
+	const TArray<URPGItem*> ChangedItems = MoveTemp(BatchedItemChanges);
+	const TArray<bool> ChangedItemAdded = MoveTemp(BatchedItemAdded);
+	const TArray<FRPGItemSlot> ChangedSlots = MoveTemp(BatchedSlotChanges);
+	BatchedItemChanges.Reset();
+	BatchedItemAdded.Reset();
+	BatchedSlotChanges.Reset();
+
+	// Notify native before blueprint
+	OnInventoryBatchChangedNative.Broadcast(ChangedItems, ChangedSlots);
+
+	// Blueprints bound to the per item events keep working, they see each changed item and slot once with its final state
+	for (int32 ItemIndex = 0; ItemIndex < ChangedItems.Num(); ItemIndex++)
+	{
+		OnInventoryItemChanged.Broadcast(ChangedItemAdded[ItemIndex], ChangedItems[ItemIndex]);
+		InventoryItemChanged(ChangedItemAdded[ItemIndex], ChangedItems[ItemIndex]);
+	}
+
+	for (const FRPGItemSlot& ItemSlot : ChangedSlots)
+	{
+		URPGItem* SlotItem = GetSlottedItem(ItemSlot);
+		OnSlottedItemChanged.Broadcast(ItemSlot, SlotItem);
+		SlottedItemChanged(ItemSlot, SlotItem);
+	}
+
+	OnInventoryBatchChanged.Broadcast(ChangedItems, ChangedSlots);
+
+	// Call BP update event
+	InventoryBatchChanged(ChangedItems, ChangedSlots);
+}
+
 void ARPGPlayerControllerBase::NotifyInventoryLoaded()
 {
+	FinishReplicatedInventorySync();
+
+	if (IsLocalController())
+	{
+		RPGBoot::EndPhase(TEXT("LoadInventory"));
+		RPGBoot::NotifyInteractive();
+	}
+
 	// Notify native before blueprint
 	OnInventoryLoadedNative.Broadcast();
 	OnInventoryLoaded.Broadcast();
 }
 
+void ARPGPlayerControllerBase::NotifyInventoryLoadProgress(float Progress)
+{
+	// Keep the loading screen up until the local player's inventory is in
+	if (IsLocalController() && IActionRPGLoadingScreenModule::IsAvailable())
+	{
+		if (Progress < 1.0f)
+		{
+			IActionRPGLoadingScreenModule::Get().SetLoadingTaskProgress(InventoryLoadTaskName, Progress);
+		}
+		else
+		{
+			IActionRPGLoadingScreenModule::Get().EndLoadingTask(InventoryLoadTaskName);
+		}
+	}
+
+	// Notify native before blueprint
+	OnInventoryLoadProgressNative.Broadcast(Progress);
+	OnInventoryLoadProgress.Broadcast(Progress);
+}
+
 void ARPGPlayerControllerBase::HandleSaveGameLoaded(URPGSaveGame* NewSaveGame)
 {
 	LoadInventory();
@@ -404,4 +986,23 @@ void ARPGPlayerControllerBase::BeginPlay()
 	LoadInventory();
 
 	Super::BeginPlay();
+}
+
+void ARPGPlayerControllerBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Don't lose changes still waiting on the save timer when quitting or travelling
+	FlushInventorySave();
+
+	if (bInventoryLoadPending && IsLocalController() && IActionRPGLoadingScreenModule::IsAvailable())
+	{
+		// The load dies with this controller, don't leave the loading screen waiting for it
+		IActionRPGLoadingScreenModule::Get().EndLoadingTask(InventoryLoadTaskName);
+	}
+
+	if (AvoidedInventorySaveCount > 0)
+	{
+		UE_LOG(LogActionRPG, Log, TEXT("Inventory saves avoided by batching: %d"), AvoidedInventorySaveCount);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
\ No newline at end of file
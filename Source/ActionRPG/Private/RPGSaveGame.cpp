@@ -2,11 +2,316 @@
 
 #include "RPGSaveGame.h"
 #include "RPGGameInstanceBase.h"
+#include "RPGStats.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace RPGSaveGameCompact
+{
+	/** Stored in front of the block so the reader knows how to decode the payload */
+	enum ECompressionMethod : uint8
+	{
+		None = 0,
+		Oodle = 1,
+	};
+
+	/** Small inventories are not worth the compression header and CPU */
+	static const int32 MinBytesToCompress = 1024;
+
+	/** Sanity limit for sizes read from disk */
+	static const uint32 MaxPayloadBytes = 64 * 1024 * 1024;
+
+	/** Collects unique names so each is written once and referenced by index */
+	struct FNameTable
+	{
+		TArray<FName> Names;
+		TMap<FName, uint32> Indices;
+
+		uint32 Add(FName Name)
+		{
+			if (const uint32* Found = Indices.Find(Name))
+			{
+				return *Found;
+			}
+			const uint32 NewIndex = Names.Add(Name);
+			Indices.Add(Name, NewIndex);
+			return NewIndex;
+		}
+	};
+
+	/** Ends the file from SectionedInventory on, followed by nothing */
+	static const uint32 SectionFooterMagic = 0x49475052; // "RPGI"
+	static const int64 SectionFooterSize = sizeof(int64) * 2 + sizeof(uint32);
+
+	static void WriteNames(FArchive& Writer, const FNameTable& NameTable)
+	{
+		uint32 NumNames = NameTable.Names.Num();
+		Writer.SerializeIntPacked(NumNames);
+		for (const FName& Name : NameTable.Names)
+		{
+			FString NameString = Name.ToString();
+			Writer << NameString;
+		}
+	}
+
+	static void WriteItems(FArchive& Writer, FNameTable& NameTable, const TMap<FPrimaryAssetId, FRPGItemData>& InventoryData)
+	{
+		uint32 NumItems = InventoryData.Num();
+		Writer.SerializeIntPacked(NumItems);
+		for (const TPair<FPrimaryAssetId, FRPGItemData>& ItemPair : InventoryData)
+		{
+			uint32 TypeIndex = NameTable.Add(ItemPair.Key.PrimaryAssetType.GetName());
+			uint32 NameIndex = NameTable.Add(ItemPair.Key.PrimaryAssetName);
+			uint32 ItemCount = (uint32)FMath::Max(ItemPair.Value.ItemCount, 0);
+			uint32 ItemLevel = (uint32)FMath::Max(ItemPair.Value.ItemLevel, 0);
+			Writer.SerializeIntPacked(TypeIndex);
+			Writer.SerializeIntPacked(NameIndex);
+			Writer.SerializeIntPacked(ItemCount);
+			Writer.SerializeIntPacked(ItemLevel);
+		}
+	}
+
+	static void WriteSlots(FArchive& Writer, FNameTable& NameTable, const TMap<FRPGItemSlot, FPrimaryAssetId>& SlottedItems)
+	{
+		uint32 NumSlots = SlottedItems.Num();
+		Writer.SerializeIntPacked(NumSlots);
+		for (const TPair<FRPGItemSlot, FPrimaryAssetId>& SlotPair : SlottedItems)
+		{
+			uint32 SlotTypeIndex = NameTable.Add(SlotPair.Key.ItemType.GetName());
+			uint32 SlotNumber = (uint32)FMath::Max(SlotPair.Key.SlotNumber, 0);
+			uint32 ItemTypeIndex = NameTable.Add(SlotPair.Value.PrimaryAssetType.GetName());
+			uint32 ItemNameIndex = NameTable.Add(SlotPair.Value.PrimaryAssetName);
+			Writer.SerializeIntPacked(SlotTypeIndex);
+			Writer.SerializeIntPacked(SlotNumber);
+			Writer.SerializeIntPacked(ItemTypeIndex);
+			Writer.SerializeIntPacked(ItemNameIndex);
+		}
+	}
+
+	/** Writes a payload with its sizes, compressing it when that pays off */
+	static void WriteBlock(FArchive& Ar, const TArray<uint8>& Payload)
+	{
+		uint8 CompressionMethod = None;
+		uint32 UncompressedSize = Payload.Num();
+		TArray<uint8> CompressedPayload;
+
+		if (Payload.Num() >= MinBytesToCompress)
+		{
+			int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, Payload.Num());
+			CompressedPayload.SetNumUninitialized(CompressedSize);
+
+			if (FCompression::CompressMemory(NAME_Oodle, CompressedPayload.GetData(), CompressedSize, Payload.GetData(), Payload.Num()) && CompressedSize < Payload.Num())
+			{
+				CompressedPayload.SetNum(CompressedSize);
+				CompressionMethod = Oodle;
+			}
+		}
+
+		Ar << CompressionMethod;
+		Ar.SerializeIntPacked(UncompressedSize);
+
+		if (CompressionMethod == Oodle)
+		{
+			uint32 CompressedSize = CompressedPayload.Num();
+			Ar.SerializeIntPacked(CompressedSize);
+			Ar.Serialize(CompressedPayload.GetData(), CompressedPayload.Num());
+		}
+		else
+		{
+			Ar.Serialize(const_cast<uint8*>(Payload.GetData()), Payload.Num());
+		}
+	}
+
+	/** Reads a block written by WriteBlock, sets the archive error and returns false if it is corrupt */
+	static bool ReadBlock(FArchive& Ar, TArray<uint8>& OutPayload)
+	{
+		uint8 CompressionMethod = None;
+		uint32 UncompressedSize = 0;
+		Ar << CompressionMethod;
+		Ar.SerializeIntPacked(UncompressedSize);
+
+		if (Ar.IsError() || UncompressedSize > MaxPayloadBytes)
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("Save game inventory block is corrupt!"));
+			Ar.SetError();
+			return false;
+		}
+
+		OutPayload.SetNumUninitialized(UncompressedSize);
+
+		if (CompressionMethod == Oodle)
+		{
+			uint32 CompressedSize = 0;
+			Ar.SerializeIntPacked(CompressedSize);
+			if (Ar.IsError() || CompressedSize > MaxPayloadBytes)
+			{
+				Ar.SetError();
+				return false;
+			}
+
+			TArray<uint8> CompressedPayload;
+			CompressedPayload.SetNumUninitialized(CompressedSize);
+			Ar.Serialize(CompressedPayload.GetData(), CompressedSize);
+
+			if (Ar.IsError() || !FCompression::UncompressMemory(NAME_Oodle, OutPayload.GetData(), UncompressedSize, CompressedPayload.GetData(), CompressedSize))
+			{
+				UE_LOG(LogActionRPG, Warning, TEXT("Failed to decompress save game inventory block!"));
+				Ar.SetError();
+				return false;
+			}
+		}
+		else if (CompressionMethod == None)
+		{
+			Ar.Serialize(OutPayload.GetData(), UncompressedSize);
+		}
+		else
+		{
+			Ar.SetError();
+			return false;
+		}
+
+		return !Ar.IsError();
+	}
+
+	static bool ReadNames(FArchive& Reader, TArray<FName>& OutNames)
+	{
+		uint32 NumNames = 0;
+		Reader.SerializeIntPacked(NumNames);
+		for (uint32 NameIndex = 0; NameIndex < NumNames && !Reader.IsError(); NameIndex++)
+		{
+			FString NameString;
+			Reader << NameString;
+			OutNames.Add(FName(*NameString));
+		}
+		return !Reader.IsError();
+	}
+
+	static FName GetName(const TArray<FName>& Names, uint32 Index)
+	{
+		return Names.IsValidIndex(Index) ? Names[Index] : NAME_None;
+	}
+
+	/**
+	 * Returns the version of a save that was loaded without a version tag, called right after the tagged properties
+	 * Saves used to leave the version out when it matched the class default, which was the latest version at the time
+	 */
+	static int32 GetUntaggedVersion(FArchive& Ar)
+	{
+		const int64 InventoryOffset = Ar.Tell();
+		if (InventoryOffset >= Ar.TotalSize())
+		{
+			// Nothing followed the tagged properties before CompactInventory
+			return ERPGSaveGameVersion::Initial;
+		}
+
+		// The sectioned layout ends with a footer pointing back at the slot section, which starts right here
+		if (Ar.TotalSize() - InventoryOffset >= SectionFooterSize)
+		{
+			int64 SlotsOffset = 0;
+			int64 ItemsOffset = 0;
+			uint32 FooterMagic = 0;
+			Ar.Seek(Ar.TotalSize() - SectionFooterSize);
+			Ar << SlotsOffset << ItemsOffset << FooterMagic;
+			Ar.Seek(InventoryOffset);
+
+			if (!Ar.IsError() && FooterMagic == SectionFooterMagic && SlotsOffset == InventoryOffset)
+			{
+				return ERPGSaveGameVersion::SectionedInventory;
+			}
+		}
+		return ERPGSaveGameVersion::CompactInventory;
+	}
+
+	static bool ReadItems(FArchive& Reader, const TArray<FName>& Names, TMap<FPrimaryAssetId, FRPGItemData>& OutInventoryData)
+	{
+		uint32 NumItems = 0;
+		Reader.SerializeIntPacked(NumItems);
+		OutInventoryData.Reset();
+		OutInventoryData.Reserve(FMath::Min<int64>(NumItems, Reader.TotalSize()));
+		for (uint32 ItemIndex = 0; ItemIndex < NumItems && !Reader.IsError(); ItemIndex++)
+		{
+			uint32 TypeIndex, NameIndex, ItemCount, ItemLevel;
+			Reader.SerializeIntPacked(TypeIndex);
+			Reader.SerializeIntPacked(NameIndex);
+			Reader.SerializeIntPacked(ItemCount);
+			Reader.SerializeIntPacked(ItemLevel);
+			OutInventoryData.Add(FPrimaryAssetId(GetName(Names, TypeIndex), GetName(Names, NameIndex)), FRPGItemData((int32)ItemCount, (int32)ItemLevel));
+		}
+		return !Reader.IsError();
+	}
+
+	static bool ReadSlots(FArchive& Reader, const TArray<FName>& Names, TMap<FRPGItemSlot, FPrimaryAssetId>& OutSlottedItems)
+	{
+		uint32 NumSlots = 0;
+		Reader.SerializeIntPacked(NumSlots);
+		OutSlottedItems.Reset();
+		for (uint32 SlotIndex = 0; SlotIndex < NumSlots && !Reader.IsError(); SlotIndex++)
+		{
+			uint32 SlotTypeIndex, SlotNumber, ItemTypeIndex, ItemNameIndex;
+			Reader.SerializeIntPacked(SlotTypeIndex);
+			Reader.SerializeIntPacked(SlotNumber);
+			Reader.SerializeIntPacked(ItemTypeIndex);
+			Reader.SerializeIntPacked(ItemNameIndex);
+			OutSlottedItems.Add(FRPGItemSlot(GetName(Names, SlotTypeIndex), (int32)SlotNumber), FPrimaryAssetId(GetName(Names, ItemTypeIndex), GetName(Names, ItemNameIndex)));
+		}
+		return !Reader.IsError();
+	}
+}
 
 void URPGSaveGame::Serialize(FArchive& Ar)
 {
+	const int64 StartOffset = Ar.Tell();
+
+	// Only save game files use the compact block, transient archives like duplication keep the normal tagged properties
+	const bool bCompactInventory = (Ar.IsSaving() || Ar.IsLoading()) && Ar.IsPersistent() && !Ar.IsObjectReferenceCollector() && !Ar.IsCountingMemory();
+
+	// Keep the inventory out of the tagged stream while saving, it is written after it in compact form
+	TMap<FPrimaryAssetId, FRPGItemData> SavingInventoryData;
+	TMap<FRPGItemSlot, FPrimaryAssetId> SavingSlottedItems;
+	if (bCompactInventory && Ar.IsSaving())
+	{
+		SavingInventoryData = MoveTemp(InventoryData);
+		SavingSlottedItems = MoveTemp(SlottedItems);
+	}
+
+	if (Ar.IsSaving())
+	{
+		// Differs from the class default, so it is always written
+		SavedDataVersion = ERPGSaveGameVersion::LatestVersion;
+	}
+
 	Super::Serialize(Ar);
 
+	if (bCompactInventory)
+	{
+		if (Ar.IsSaving())
+		{
+			InventoryData = MoveTemp(SavingInventoryData);
+			SlottedItems = MoveTemp(SavingSlottedItems);
+			SerializeCompactInventory(Ar);
+		}
+		else
+		{
+			if (SavedDataVersion == ERPGSaveGameVersion::Initial)
+			{
+				SavedDataVersion = RPGSaveGameCompact::GetUntaggedVersion(Ar);
+			}
+
+			// FRPGSaveGameReader only hands over the part in front of the inventory and decodes the sections itself
+			if (SavedDataVersion >= ERPGSaveGameVersion::CompactInventory && Ar.Tell() < Ar.TotalSize())
+			{
+				SerializeCompactInventory(Ar);
+			}
+		}
+	}
+
+	// Track how large save data is on disk, ignoring reference collection and memory counting archives
+	if ((Ar.IsSaving() || Ar.IsLoading()) && !Ar.IsObjectReferenceCollector() && !Ar.IsCountingMemory() && StartOffset != INDEX_NONE)
+	{
+		RPGStats::RecordSaveGameSize(Ar.Tell() - StartOffset, Ar.IsLoading());
+	}
+
 	if (Ar.IsLoading() && SavedDataVersion != ERPGSaveGameVersion::LatestVersion)
 	{
 		if (SavedDataVersion < ERPGSaveGameVersion::AddedItemData)
@@ -19,7 +324,127 @@ void URPGSaveGame::Serialize(FArchive& Ar)
 
 			InventoryItems_DEPRECATED.Empty();
 		}
+
+		// Saves older than CompactInventory already read their inventory from the tagged properties, nothing to convert
 		
 		SavedDataVersion = ERPGSaveGameVersion::LatestVersion;
 	}
-}
\ No newline at end of file
+}
+
+void URPGSaveGame::SerializeCompactInventory(FArchive& Ar)
+{
+	using namespace RPGSaveGameCompact;
+
+	if (Ar.IsSaving())
+	{
+		// Slots go first so a lazy reader can decode them without touching the much larger item section
+		TArray<uint8> SlotsPayload;
+		{
+			FNameTable NameTable;
+			for (const TPair<FRPGItemSlot, FPrimaryAssetId>& SlotPair : SlottedItems)
+			{
+				NameTable.Add(SlotPair.Key.ItemType.GetName());
+				NameTable.Add(SlotPair.Value.PrimaryAssetType.GetName());
+				NameTable.Add(SlotPair.Value.PrimaryAssetName);
+			}
+
+			FMemoryWriter Writer(SlotsPayload);
+			WriteNames(Writer, NameTable);
+			WriteSlots(Writer, NameTable, SlottedItems);
+		}
+
+		TArray<uint8> ItemsPayload;
+		{
+			FNameTable NameTable;
+			for (const TPair<FPrimaryAssetId, FRPGItemData>& ItemPair : InventoryData)
+			{
+				NameTable.Add(ItemPair.Key.PrimaryAssetType.GetName());
+				NameTable.Add(ItemPair.Key.PrimaryAssetName);
+			}
+
+			FMemoryWriter Writer(ItemsPayload);
+			WriteNames(Writer, NameTable);
+			WriteItems(Writer, NameTable, InventoryData);
+		}
+
+		int64 SlotsOffset = Ar.Tell();
+		WriteBlock(Ar, SlotsPayload);
+		int64 ItemsOffset = Ar.Tell();
+		WriteBlock(Ar, ItemsPayload);
+
+		// Fixed size footer at the very end of the file, lets FRPGSaveGameReader find the sections without parsing the save
+		uint32 FooterMagic = SectionFooterMagic;
+		Ar << SlotsOffset << ItemsOffset << FooterMagic;
+		return;
+	}
+
+	if (SavedDataVersion < ERPGSaveGameVersion::SectionedInventory)
+	{
+		// One block with a shared name table, items before slots
+		TArray<uint8> Payload;
+		if (!ReadBlock(Ar, Payload))
+		{
+			return;
+		}
+
+		FMemoryReader Reader(Payload);
+		TArray<FName> Names;
+		if (!ReadNames(Reader, Names) || !ReadItems(Reader, Names, InventoryData) || !ReadSlots(Reader, Names, SlottedItems))
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("Save game inventory block is truncated!"));
+			Ar.SetError();
+		}
+		return;
+	}
+
+	if (!ReadSlottedItemsSection(Ar, SlottedItems) || !ReadInventoryItemsSection(Ar, InventoryData))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	int64 SlotsOffset = 0;
+	int64 ItemsOffset = 0;
+	uint32 FooterMagic = 0;
+	Ar << SlotsOffset << ItemsOffset << FooterMagic;
+}
+
+bool URPGSaveGame::ReadSlottedItemsSection(FArchive& Ar, TMap<FRPGItemSlot, FPrimaryAssetId>& OutSlottedItems)
+{
+	using namespace RPGSaveGameCompact;
+
+	TArray<uint8> Payload;
+	if (!ReadBlock(Ar, Payload))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Payload);
+	TArray<FName> Names;
+	if (!ReadNames(Reader, Names) || !ReadSlots(Reader, Names, OutSlottedItems))
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("Save game slot section is truncated!"));
+		return false;
+	}
+	return true;
+}
+
+bool URPGSaveGame::ReadInventoryItemsSection(FArchive& Ar, TMap<FPrimaryAssetId, FRPGItemData>& OutInventoryData)
+{
+	using namespace RPGSaveGameCompact;
+
+	TArray<uint8> Payload;
+	if (!ReadBlock(Ar, Payload))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Payload);
+	TArray<FName> Names;
+	if (!ReadNames(Reader, Names) || !ReadItems(Reader, Names, OutInventoryData))
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("Save game item section is truncated!"));
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGSaveGameReader.h"
+#include "RPGSaveGame.h"
+#include "Kismet/GameplayStatics.h"
+#include "Async/Async.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Serialization/MemoryReader.h"
+
+namespace RPGSaveGameReader
+{
+	/** Must match the footer written by URPGSaveGame::SerializeCompactInventory */
+	static const uint32 FooterMagic = 0x49475052; // "RPGI"
+	static const int64 FooterSize = sizeof(int64) * 2 + sizeof(uint32);
+}
+
+FRPGSaveGameReader::FRPGSaveGameReader()
+	: SlotsOffset(0)
+	, ItemsOffset(0)
+	, FooterOffset(0)
+{
+}
+
+FRPGSaveGameReader::~FRPGSaveGameReader()
+{
+	Close();
+}
+
+bool FRPGSaveGameReader::Open(const FString& Filename)
+{
+	using namespace RPGSaveGameReader;
+
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	MappedFile.Reset(PlatformFile.OpenMapped(*Filename));
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() < FooterSize)
+	{
+		Close();
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion.IsValid())
+	{
+		Close();
+		return false;
+	}
+
+	// Only the footer is touched here, the rest of the file is paged in when it is read
+	FooterOffset = MappedRegion->GetMappedSize() - FooterSize;
+	FMemoryReaderView FooterReader(GetView(FooterOffset, MappedRegion->GetMappedSize()));
+
+	uint32 Magic = 0;
+	FooterReader << SlotsOffset << ItemsOffset << Magic;
+
+	if (FooterReader.IsError() || Magic != FooterMagic || SlotsOffset <= 0 || SlotsOffset > ItemsOffset || ItemsOffset > FooterOffset)
+	{
+		// Older save, or not one of ours
+		Close();
+		return false;
+	}
+	return true;
+}
+
+URPGSaveGame* FRPGSaveGameReader::LoadSaveGame()
+{
+	check(IsInGameThread());
+
+	if (!IsOpen())
+	{
+		return nullptr;
+	}
+
+	// The header and tagged properties are small, copy just those. Without the data behind them the save game loads without its inventory
+	const TArrayView<const uint8> TaggedView = GetView(0, SlotsOffset);
+	TArray<uint8> TaggedData(TaggedView.GetData(), TaggedView.Num());
+
+	URPGSaveGame* SaveGame = Cast<URPGSaveGame>(UGameplayStatics::LoadGameFromMemory(TaggedData));
+
+	if (SaveGame)
+	{
+		FMemoryReaderView SlotReader(GetView(SlotsOffset, ItemsOffset));
+		if (!URPGSaveGame::ReadSlottedItemsSection(SlotReader, SaveGame->SlottedItems))
+		{
+			return nullptr;
+		}
+	}
+	return SaveGame;
+}
+
+void FRPGSaveGameReader::DecodeInventoryItemsAsync(URPGSaveGame* SaveGame, TFunction<void(bool)> OnComplete)
+{
+	check(IsInGameThread());
+
+	if (!IsOpen() || !SaveGame)
+	{
+		OnComplete(false);
+		return;
+	}
+
+	TWeakObjectPtr<URPGSaveGame> WeakSaveGame(SaveGame);
+	Async(EAsyncExecution::ThreadPool, [This = AsShared(), WeakSaveGame, OnComplete = MoveTemp(OnComplete)]() mutable
+	{
+		TMap<FPrimaryAssetId, FRPGItemData> InventoryData;
+		FMemoryReaderView ItemReader(This->GetView(This->ItemsOffset, This->FooterOffset));
+		const bool bDecoded = URPGSaveGame::ReadInventoryItemsSection(ItemReader, InventoryData);
+
+		AsyncTask(ENamedThreads::GameThread, [This, WeakSaveGame, OnComplete = MoveTemp(OnComplete), InventoryData = MoveTemp(InventoryData), bDecoded]() mutable
+		{
+			// The mapping is not needed anymore once the last section is decoded
+			This->Close();
+
+			URPGSaveGame* LoadedSaveGame = WeakSaveGame.Get();
+			if (bDecoded && LoadedSaveGame)
+			{
+				LoadedSaveGame->InventoryData = MoveTemp(InventoryData);
+			}
+			OnComplete(bDecoded && LoadedSaveGame);
+		});
+	});
+}
+
+void FRPGSaveGameReader::Close()
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+TArrayView<const uint8> FRPGSaveGameReader::GetView(int64 Offset, int64 End) const
+{
+	return TArrayView<const uint8>(MappedRegion->GetMappedPtr() + Offset, (int32)(End - Offset));
+}
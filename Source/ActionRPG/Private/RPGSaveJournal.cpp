@@ -0,0 +1,289 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGSaveJournal.h"
+#include "RPGSaveGame.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace RPGSaveJournal
+{
+	static const uint32 Magic = 0x4A475052; // "RPGJ"
+	static const int32 Version = 1;
+
+	/** Every record starts with one of these */
+	enum ERecordType : uint8
+	{
+		// Defines the next string table entry: FString
+		String = 1,
+		// Item data change: type index, name index, count, level
+		Item = 2,
+		// Slot change: slot type index, slot number, item type index, item name index
+		Slot = 3,
+	};
+
+	static void WriteHeader(FArchive& Ar, int32 Generation)
+	{
+		uint32 HeaderMagic = Magic;
+		int32 HeaderVersion = Version;
+		Ar << HeaderMagic << HeaderVersion << Generation;
+	}
+}
+
+FRPGSaveJournal::FRPGSaveJournal()
+	: Generation(INDEX_NONE)
+	, WrittenRecordCount(0)
+{
+}
+
+int32 FRPGSaveJournal::Replay(const FString& InFilename, URPGSaveGame* SaveGame)
+{
+	check(SaveGame);
+
+	Discard();
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *InFilename, FILEREAD_Silent))
+	{
+		Reset(InFilename, SaveGame->JournalGeneration);
+		return 0;
+	}
+
+	FMemoryReader Reader(FileData);
+
+	uint32 FileMagic = 0;
+	int32 FileVersion = 0;
+	int32 FileGeneration = INDEX_NONE;
+	Reader << FileMagic << FileVersion << FileGeneration;
+
+	if (Reader.IsError() || FileMagic != RPGSaveJournal::Magic || FileVersion != RPGSaveJournal::Version || FileGeneration != SaveGame->JournalGeneration)
+	{
+		// Either garbage or a journal for an older snapshot that already contains these changes
+		Reset(InFilename, SaveGame->JournalGeneration);
+		return 0;
+	}
+
+	Filename = InFilename;
+	Generation = FileGeneration;
+
+	auto GetString = [this](int32 Index) -> FName
+	{
+		return Strings.IsValidIndex(Index) ? Strings[Index] : NAME_None;
+	};
+
+	int64 LastGoodOffset = Reader.Tell();
+	while (Reader.Tell() < Reader.TotalSize())
+	{
+		uint8 RecordType = 0;
+		Reader << RecordType;
+
+		if (RecordType == RPGSaveJournal::String)
+		{
+			FString Value;
+			Reader << Value;
+
+			if (!Reader.IsError())
+			{
+				const FName Name(*Value);
+				StringIndices.Add(Name, Strings.Add(Name));
+			}
+		}
+		else if (RecordType == RPGSaveJournal::Item)
+		{
+			int32 TypeIndex, NameIndex, ItemCount, ItemLevel;
+			Reader << TypeIndex << NameIndex << ItemCount << ItemLevel;
+
+			if (!Reader.IsError())
+			{
+				const FPrimaryAssetId ItemId(GetString(TypeIndex), GetString(NameIndex));
+				if (ItemCount > 0)
+				{
+					SaveGame->InventoryData.Add(ItemId, FRPGItemData(ItemCount, ItemLevel));
+				}
+				else
+				{
+					SaveGame->InventoryData.Remove(ItemId);
+				}
+				WrittenRecordCount++;
+			}
+		}
+		else if (RecordType == RPGSaveJournal::Slot)
+		{
+			int32 SlotTypeIndex, SlotNumber, ItemTypeIndex, ItemNameIndex;
+			Reader << SlotTypeIndex << SlotNumber << ItemTypeIndex << ItemNameIndex;
+
+			if (!Reader.IsError())
+			{
+				const FRPGItemSlot ItemSlot(GetString(SlotTypeIndex), SlotNumber);
+				const FPrimaryAssetId ItemId = ItemNameIndex == INDEX_NONE ? FPrimaryAssetId() : FPrimaryAssetId(GetString(ItemTypeIndex), GetString(ItemNameIndex));
+				SaveGame->SlottedItems.Add(ItemSlot, ItemId);
+				WrittenRecordCount++;
+			}
+		}
+		else
+		{
+			Reader.SetError();
+		}
+
+		if (Reader.IsError())
+		{
+			break;
+		}
+		LastGoodOffset = Reader.Tell();
+	}
+
+	if (LastGoodOffset < FileData.Num())
+	{
+		// The last write was cut short, drop the partial record so new records are appended after valid data
+		UE_LOG(LogActionRPG, Warning, TEXT("Save journal %s had %d bytes of incomplete data, discarding them"), *Filename, (int32)(FileData.Num() - LastGoodOffset));
+		FileData.SetNum((int32)LastGoodOffset);
+		FFileHelper::SaveArrayToFile(FileData, *Filename);
+	}
+
+	return WrittenRecordCount;
+}
+
+bool FRPGSaveJournal::Reset(const FString& InFilename, int32 InGeneration)
+{
+	Close();
+
+	TArray<uint8> HeaderData;
+	FMemoryWriter Writer(HeaderData);
+	RPGSaveJournal::WriteHeader(Writer, InGeneration);
+
+	if (!FFileHelper::SaveArrayToFile(HeaderData, *InFilename))
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("Failed to create save journal %s"), *InFilename);
+		return false;
+	}
+
+	Filename = InFilename;
+	Generation = InGeneration;
+	return true;
+}
+
+void FRPGSaveJournal::Discard()
+{
+	ClearPendingRecords();
+	Close();
+}
+
+void FRPGSaveJournal::Close()
+{
+	StringIndices.Reset();
+	Strings.Reset();
+	Filename.Reset();
+	Generation = INDEX_NONE;
+	WrittenRecordCount = 0;
+}
+
+void FRPGSaveJournal::Delete(const FString& InFilename)
+{
+	Discard();
+	IFileManager::Get().Delete(*InFilename, false, false, true);
+}
+
+void FRPGSaveJournal::RecordItem(const FPrimaryAssetId& ItemId, const FRPGItemData& ItemData)
+{
+	PendingItems.Add(ItemId, ItemData.IsValid() ? ItemData : FRPGItemData(0, 0));
+}
+
+void FRPGSaveJournal::RecordSlot(const FRPGItemSlot& ItemSlot, const FPrimaryAssetId& ItemId)
+{
+	PendingSlots.Add(ItemSlot, ItemId);
+}
+
+void FRPGSaveJournal::ClearPendingRecords()
+{
+	PendingItems.Reset();
+	PendingSlots.Reset();
+}
+
+int32 FRPGSaveJournal::GetStringIndex(FName Name, FArchive& Ar)
+{
+	if (const int32* FoundIndex = StringIndices.Find(Name))
+	{
+		return *FoundIndex;
+	}
+
+	uint8 RecordType = RPGSaveJournal::String;
+	FString Value = Name.ToString();
+	Ar << RecordType << Value;
+
+	const int32 NewIndex = Strings.Add(Name);
+	StringIndices.Add(Name, NewIndex);
+	return NewIndex;
+}
+
+bool FRPGSaveJournal::Flush()
+{
+	if (!IsOpen())
+	{
+		return false;
+	}
+
+	if (!HasPendingRecords())
+	{
+		return true;
+	}
+
+	// Encode everything first so the file only sees a single append
+	TArray<uint8> RecordData;
+	FMemoryWriter Writer(RecordData);
+
+	for (const TPair<FPrimaryAssetId, FRPGItemData>& ItemPair : PendingItems)
+	{
+		int32 TypeIndex = GetStringIndex(ItemPair.Key.PrimaryAssetType.GetName(), Writer);
+		int32 NameIndex = GetStringIndex(ItemPair.Key.PrimaryAssetName, Writer);
+		uint8 RecordType = RPGSaveJournal::Item;
+		int32 ItemCount = ItemPair.Value.ItemCount;
+		int32 ItemLevel = ItemPair.Value.ItemLevel;
+		Writer << RecordType << TypeIndex << NameIndex << ItemCount << ItemLevel;
+	}
+
+	for (const TPair<FRPGItemSlot, FPrimaryAssetId>& SlotPair : PendingSlots)
+	{
+		int32 SlotTypeIndex = GetStringIndex(SlotPair.Key.ItemType.GetName(), Writer);
+		int32 SlotNumber = SlotPair.Key.SlotNumber;
+		int32 ItemTypeIndex = INDEX_NONE;
+		int32 ItemNameIndex = INDEX_NONE;
+		if (SlotPair.Value.IsValid())
+		{
+			ItemTypeIndex = GetStringIndex(SlotPair.Value.PrimaryAssetType.GetName(), Writer);
+			ItemNameIndex = GetStringIndex(SlotPair.Value.PrimaryAssetName, Writer);
+		}
+		uint8 RecordType = RPGSaveJournal::Slot;
+		Writer << RecordType << SlotTypeIndex << SlotNumber << ItemTypeIndex << ItemNameIndex;
+	}
+
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_Append | FILEWRITE_Silent));
+	if (!FileWriter)
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("Failed to open save journal %s for append"), *Filename);
+		CloseAfterFailedWrite();
+		return false;
+	}
+
+	FileWriter->Serialize(RecordData.GetData(), RecordData.Num());
+	if (!FileWriter->Close())
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("Failed to append to save journal %s"), *Filename);
+		CloseAfterFailedWrite();
+		return false;
+	}
+
+	WrittenRecordCount += PendingItems.Num() + PendingSlots.Num();
+	ClearPendingRecords();
+
+	return true;
+}
+
+void FRPGSaveJournal::CloseAfterFailedWrite()
+{
+	// The string table entries may not be on disk, so start the table over with the next journal.
+	// Queued records are kept, the full save that replaces this journal picks them up
+	StringIndices.Reset();
+	Strings.Reset();
+	Filename.Reset();
+}
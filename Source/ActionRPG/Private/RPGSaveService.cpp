@@ -0,0 +1,282 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGSaveService.h"
+#include "GameFramework/SaveGame.h"
+#include "Kismet/GameplayStatics.h"
+#include "Async/Async.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+
+FRPGSaveService::FRPGSaveService()
+	: WorkEvent(nullptr)
+	, Thread(nullptr)
+	, bStopping(false)
+	, NumMergedSaves(0)
+{
+}
+
+FRPGSaveService::~FRPGSaveService()
+{
+	Shutdown();
+}
+
+bool FRPGSaveService::Start()
+{
+	if (Thread)
+	{
+		return true;
+	}
+
+	bStopping = false;
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("RPGSaveService"), 0, TPri_BelowNormal);
+
+	if (!Thread)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		WorkEvent = nullptr;
+		return false;
+	}
+	return true;
+}
+
+void FRPGSaveService::Shutdown()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	// The thread drains the queue before it exits, so nothing that was requested is lost
+	Stop();
+	Thread->WaitForCompletion();
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+}
+
+TFuture<bool> FRPGSaveService::SaveGameAsync(USaveGame* SaveGame, const FString& SlotName, int32 UserIndex)
+{
+	check(IsInGameThread());
+
+	TSharedRef<TPromise<bool>> Promise = MakeShared<TPromise<bool>>();
+	TFuture<bool> Future = Promise->GetFuture();
+
+	TArray<uint8> Data;
+	if (!SaveGame || !UGameplayStatics::SaveGameToMemory(SaveGame, Data))
+	{
+		Promise->SetValue(false);
+		return Future;
+	}
+
+	const FString Filename = GetSaveFilename(SlotName, UserIndex);
+	if (!Thread)
+	{
+		FRequest Request;
+		Request.Filename = Filename;
+		Request.Data = MoveTemp(Data);
+		Request.SavePromises.Add(Promise);
+		ProcessRequest(Request);
+		return Future;
+	}
+
+	{
+		FScopeLock Lock(&QueueCriticalSection);
+
+		// Replace a save of this slot that has not started yet, unless a load of the slot is queued after it and must see the older data
+		for (int32 Index = Queue.Num() - 1; Index >= 0; Index--)
+		{
+			FRequest& Queued = Queue[Index];
+			if (Queued.Filename == Filename)
+			{
+				if (!Queued.LoadPromise.IsValid())
+				{
+					Queued.Data = MoveTemp(Data);
+					Queued.SavePromises.Add(Promise);
+					NumMergedSaves++;
+					return Future;
+				}
+				break;
+			}
+		}
+
+		FRequest& Request = Queue.AddDefaulted_GetRef();
+		Request.Filename = Filename;
+		Request.Data = MoveTemp(Data);
+		Request.SavePromises.Add(Promise);
+	}
+
+	WorkEvent->Trigger();
+	return Future;
+}
+
+TFuture<USaveGame*> FRPGSaveService::LoadGameAsync(const FString& SlotName, int32 UserIndex)
+{
+	check(IsInGameThread());
+
+	TSharedRef<TPromise<USaveGame*>> Promise = MakeShared<TPromise<USaveGame*>>();
+	TFuture<USaveGame*> Future = Promise->GetFuture();
+
+	if (!Thread)
+	{
+		Promise->SetValue(LoadGame(SlotName, UserIndex));
+		return Future;
+	}
+
+	{
+		FScopeLock Lock(&QueueCriticalSection);
+
+		FRequest& Request = Queue.AddDefaulted_GetRef();
+		Request.Filename = GetSaveFilename(SlotName, UserIndex);
+		Request.SlotName = SlotName;
+		Request.UserIndex = UserIndex;
+		Request.LoadPromise = Promise;
+	}
+
+	WorkEvent->Trigger();
+	return Future;
+}
+
+int32 FRPGSaveService::GetNumQueuedRequests() const
+{
+	FScopeLock Lock(&QueueCriticalSection);
+	return Queue.Num();
+}
+
+FString FRPGSaveService::GetSaveFilename(const FString& SlotName, int32 UserIndex)
+{
+	return FPaths::ProjectSavedDir() / TEXT("SaveGames") / FString::Printf(TEXT("%s_%d.sav"), *SlotName, UserIndex);
+}
+
+FString FRPGSaveService::FindSaveFileToLoad(const FString& SlotName, int32 UserIndex)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	const FString Filename = GetSaveFilename(SlotName, UserIndex);
+
+	// Without the save, a write was interrupted. The backup was a complete save before it was renamed, while the temporary
+	// file may have been cut off while it was written, so it is only used when there is nothing else, as with a first save
+	const FString Candidates[] =
+	{
+		Filename,
+		Filename + TEXT(".bak"),
+		Filename + TEXT(".tmp"),
+		// Saves written before the user index was part of the name
+		FPaths::ProjectSavedDir() / TEXT("SaveGames") / SlotName + TEXT(".sav"),
+	};
+
+	for (const FString& Candidate : Candidates)
+	{
+		if (FileManager.FileExists(*Candidate))
+		{
+			UE_CLOG(&Candidate != &Candidates[0], LogActionRPG, Warning, TEXT("FRPGSaveService: %s is missing, loading %s instead"), *Filename, *Candidate);
+			return Candidate;
+		}
+	}
+	return FString();
+}
+
+USaveGame* FRPGSaveService::LoadGame(const FString& SlotName, int32 UserIndex)
+{
+	check(IsInGameThread());
+
+	const FString Filename = FindSaveFileToLoad(SlotName, UserIndex);
+
+	TArray<uint8> Data;
+	if (Filename.IsEmpty() || !FFileHelper::LoadFileToArray(Data, *Filename, FILEREAD_Silent))
+	{
+		return nullptr;
+	}
+	return UGameplayStatics::LoadGameFromMemory(Data);
+}
+
+bool FRPGSaveService::WriteSaveFile(const TArray<uint8>& Data, const FString& Filename)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	const FString TempFilename = Filename + TEXT(".tmp");
+	const FString BackupFilename = Filename + TEXT(".bak");
+
+	if (!FFileHelper::SaveArrayToFile(Data, *TempFilename))
+	{
+		return false;
+	}
+
+	// Replacing the save directly deletes it before the rename on some platforms. Moving it to the backup first
+	// means the old save, or the new one in the temporary file, is complete on disk at every point
+	if (FileManager.FileExists(*Filename) && !FileManager.Move(*BackupFilename, *Filename, true, true))
+	{
+		return false;
+	}
+	return FileManager.Move(*Filename, *TempFilename, false, true);
+}
+
+uint32 FRPGSaveService::Run()
+{
+	while (true)
+	{
+		WorkEvent->Wait();
+
+		while (true)
+		{
+			FRequest Request;
+			{
+				FScopeLock Lock(&QueueCriticalSection);
+				if (Queue.Num() == 0)
+				{
+					break;
+				}
+				Request = MoveTemp(Queue[0]);
+				Queue.RemoveAt(0, 1, EAllowShrinking::No);
+			}
+
+			ProcessRequest(Request);
+		}
+
+		if (bStopping)
+		{
+			break;
+		}
+	}
+	return 0;
+}
+
+void FRPGSaveService::Stop()
+{
+	bStopping = true;
+	if (WorkEvent)
+	{
+		WorkEvent->Trigger();
+	}
+}
+
+void FRPGSaveService::ProcessRequest(FRequest& Request)
+{
+	if (Request.LoadPromise.IsValid())
+	{
+		const FString Filename = FindSaveFileToLoad(Request.SlotName, Request.UserIndex);
+
+		TArray<uint8> Data;
+		const bool bRead = !Filename.IsEmpty() && FFileHelper::LoadFileToArray(Data, *Filename, FILEREAD_Silent);
+
+		// Save game objects can only be created on the game thread
+		AsyncTask(ENamedThreads::GameThread, [Promise = Request.LoadPromise, Data = MoveTemp(Data), bRead]()
+		{
+			Promise->SetValue(bRead ? UGameplayStatics::LoadGameFromMemory(Data) : nullptr);
+		});
+		return;
+	}
+
+	const bool bSuccess = WriteSaveFile(Request.Data, Request.Filename);
+
+	UE_CLOG(!bSuccess, LogActionRPG, Warning, TEXT("FRPGSaveService: Failed to write %s"), *Request.Filename);
+
+	AsyncTask(ENamedThreads::GameThread, [Promises = MoveTemp(Request.SavePromises), bSuccess]()
+	{
+		for (const TSharedRef<TPromise<bool>>& Promise : Promises)
+		{
+			Promise->SetValue(bSuccess);
+		}
+	});
+}
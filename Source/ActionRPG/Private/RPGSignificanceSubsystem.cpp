@@ -0,0 +1,256 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGSignificanceSubsystem.h"
+#include "RPGStats.h"
+
+URPGSignificanceSubsystem::URPGSignificanceSubsystem()
+	: UpdateInterval(0.25f)
+	, MaxDistance(6000.0f)
+	, AlwaysInViewDistance(1000.0f)
+	, ViewHalfAngle(60.0f)
+	, OutOfViewScale(0.5f)
+	, Hysteresis(0.05f)
+	, TimeSinceUpdate(0.0f)
+{
+	TierSettings.SetNum(4);
+
+	FRPGSignificanceTierSettings& High = TierSettings[(int32)ERPGSignificanceTier::High];
+	High.MinSignificance = 0.7f;
+
+	FRPGSignificanceTierSettings& Medium = TierSettings[(int32)ERPGSignificanceTier::Medium];
+	Medium.MinSignificance = 0.4f;
+	Medium.MovementTickInterval = 0.033f;
+	Medium.AIThinkInterval = 0.1f;
+	Medium.ProjectileTickInterval = 0.033f;
+
+	FRPGSignificanceTierSettings& Low = TierSettings[(int32)ERPGSignificanceTier::Low];
+	Low.MinSignificance = 0.15f;
+	Low.MovementTickInterval = 0.1f;
+	Low.bSimplifiedMovement = true;
+	Low.AIThinkInterval = 0.25f;
+	Low.ProjectileTickInterval = 0.1f;
+	Low.bSpawnEffects = false;
+
+	FRPGSignificanceTierSettings& Dormant = TierSettings[(int32)ERPGSignificanceTier::Dormant];
+	Dormant.MinSignificance = 0.0f;
+	Dormant.MovementTickInterval = 0.25f;
+	Dormant.bSimplifiedMovement = true;
+	Dormant.AIThinkInterval = 0.5f;
+	Dormant.ProjectileTickInterval = 0.25f;
+	Dormant.bSpawnEffects = false;
+}
+
+bool URPGSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId URPGSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URPGSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+URPGSignificanceSubsystem* URPGSignificanceSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<URPGSignificanceSubsystem>() : nullptr;
+}
+
+ERPGSignificanceTier URPGSignificanceSubsystem::GetActorTier(const AActor* Actor)
+{
+	URPGSignificanceSubsystem* Subsystem = Get(Actor);
+	return Subsystem ? Subsystem->GetTier(Actor) : ERPGSignificanceTier::High;
+}
+
+const FRPGSignificanceTierSettings& URPGSignificanceSubsystem::GetActorTierSettings(const AActor* Actor)
+{
+	URPGSignificanceSubsystem* Subsystem = Get(Actor);
+	if (Subsystem)
+	{
+		return Subsystem->GetTierSettings(Subsystem->GetTier(Actor));
+	}
+
+	static const FRPGSignificanceTierSettings FullFidelity;
+	return FullFidelity;
+}
+
+void URPGSignificanceSubsystem::RegisterActor(AActor* Actor, FOnSignificanceTierChanged&& OnTierChanged)
+{
+	if (!Actor || EntryIndices.Contains(Actor))
+	{
+		return;
+	}
+
+	TArray<FViewer, TInlineAllocator<4>> Viewers;
+	GatherViewers(Viewers);
+
+	// Score now so short lived actors like projectiles start in the right tier
+	const int32 Index = Entries.AddDefaulted();
+	FEntry& Entry = Entries[Index];
+	Entry.Actor = Actor;
+	Entry.OnTierChanged = MoveTemp(OnTierChanged);
+	Entry.Significance = CalculateSignificance(Actor, Viewers);
+	Entry.Tier = GetTierForSignificance(Entry.Significance, ERPGSignificanceTier::Dormant);
+	EntryIndices.Add(Actor, Index);
+
+	INC_DWORD_STAT(STAT_RPG_SignificanceActors);
+
+	Entry.OnTierChanged.ExecuteIfBound(Entry.Tier);
+}
+
+void URPGSignificanceSubsystem::UnregisterActor(AActor* Actor)
+{
+	int32 Index = INDEX_NONE;
+	if (!EntryIndices.RemoveAndCopyValue(Actor, Index))
+	{
+		return;
+	}
+
+	Entries.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (Entries.IsValidIndex(Index))
+	{
+		// The last entry moved into the hole
+		if (AActor* MovedActor = Entries[Index].Actor.Get())
+		{
+			EntryIndices.Add(MovedActor, Index);
+		}
+	}
+
+	DEC_DWORD_STAT(STAT_RPG_SignificanceActors);
+}
+
+float URPGSignificanceSubsystem::GetSignificance(const AActor* Actor) const
+{
+	const int32* Index = EntryIndices.Find(Actor);
+	return Index ? Entries[*Index].Significance : 1.0f;
+}
+
+ERPGSignificanceTier URPGSignificanceSubsystem::GetTier(const AActor* Actor) const
+{
+	const int32* Index = EntryIndices.Find(Actor);
+	return Index ? Entries[*Index].Tier : ERPGSignificanceTier::High;
+}
+
+const FRPGSignificanceTierSettings& URPGSignificanceSubsystem::GetTierSettings(ERPGSignificanceTier Tier) const
+{
+	const int32 TierIndex = FMath::Min((int32)Tier, TierSettings.Num() - 1);
+	return TierSettings[TierIndex];
+}
+
+void URPGSignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate >= UpdateInterval)
+	{
+		TimeSinceUpdate = 0.0f;
+		UpdateSignificance();
+	}
+}
+
+void URPGSignificanceSubsystem::GatherViewers(TArray<FViewer, TInlineAllocator<4>>& OutViewers) const
+{
+	// On a server this is every connected player, on a client only the local ones
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (!PlayerController || !PlayerController->GetPawnOrSpectator())
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		FViewer& Viewer = OutViewers.AddDefaulted_GetRef();
+		Viewer.Location = ViewLocation;
+		Viewer.Direction = ViewRotation.Vector();
+	}
+}
+
+float URPGSignificanceSubsystem::CalculateSignificance(const AActor* Actor, const TArray<FViewer, TInlineAllocator<4>>& Viewers) const
+{
+	const APawn* Pawn = Cast<APawn>(Actor);
+	if (Pawn && Pawn->IsPlayerControlled())
+	{
+		return 1.0f;
+	}
+
+	const FVector Location = Actor->GetActorLocation();
+	const float CosViewHalfAngle = FMath::Cos(FMath::DegreesToRadians(ViewHalfAngle));
+	const float SafeMaxDistance = FMath::Max(MaxDistance, 1.0f);
+
+	float Significance = 0.0f;
+	for (const FViewer& Viewer : Viewers)
+	{
+		const FVector ToActor = Location - Viewer.Location;
+		const float Distance = ToActor.Size();
+
+		float ViewerSignificance = 1.0f - FMath::Min(Distance / SafeMaxDistance, 1.0f);
+		if (Distance > AlwaysInViewDistance && FVector::DotProduct(ToActor / Distance, Viewer.Direction) < CosViewHalfAngle)
+		{
+			ViewerSignificance *= OutOfViewScale;
+		}
+
+		Significance = FMath::Max(Significance, ViewerSignificance);
+	}
+
+	return Significance;
+}
+
+ERPGSignificanceTier URPGSignificanceSubsystem::GetTierForSignificance(float Significance, ERPGSignificanceTier CurrentTier) const
+{
+	for (int32 TierIndex = 0; TierIndex < TierSettings.Num(); TierIndex++)
+	{
+		// The current tier only needs to be held, not reached again
+		const float Threshold = TierSettings[TierIndex].MinSignificance - (TierIndex == (int32)CurrentTier ? Hysteresis : 0.0f);
+		if (Significance >= Threshold)
+		{
+			return (ERPGSignificanceTier)TierIndex;
+		}
+	}
+
+	return ERPGSignificanceTier::Dormant;
+}
+
+void URPGSignificanceSubsystem::UpdateSignificance()
+{
+	RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_SignificanceUpdate);
+
+	TArray<FViewer, TInlineAllocator<4>> Viewers;
+	GatherViewers(Viewers);
+
+	// Notified after scoring, so callbacks can register or unregister actors
+	TArray<TPair<TWeakObjectPtr<AActor>, ERPGSignificanceTier>, TInlineAllocator<16>> TierChanges;
+
+	for (FEntry& Entry : Entries)
+	{
+		const AActor* Actor = Entry.Actor.Get();
+		if (!Actor)
+		{
+			continue;
+		}
+
+		Entry.Significance = CalculateSignificance(Actor, Viewers);
+
+		const ERPGSignificanceTier NewTier = GetTierForSignificance(Entry.Significance, Entry.Tier);
+		if (NewTier != Entry.Tier)
+		{
+			Entry.Tier = NewTier;
+			TierChanges.Emplace(Entry.Actor, NewTier);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_RPG_SignificanceTierChanges, TierChanges.Num());
+
+	for (const TPair<TWeakObjectPtr<AActor>, ERPGSignificanceTier>& TierChange : TierChanges)
+	{
+		const int32* Index = EntryIndices.Find(TierChange.Key.Get());
+		if (Index)
+		{
+			Entries[*Index].OnTierChanged.ExecuteIfBound(TierChange.Value);
+		}
+	}
+}
@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGStats.h"
+
+DEFINE_STAT(STAT_RPG_FindNearestTarget);
+DEFINE_STAT(STAT_RPG_ProjectileHit);
+DEFINE_STAT(STAT_RPG_PostGameplayEffectExecute);
+DEFINE_STAT(STAT_RPG_SaveInventory);
+DEFINE_STAT(STAT_RPG_LoadInventory);
+DEFINE_STAT(STAT_RPG_RefreshSlottedAbilities);
+DEFINE_STAT(STAT_RPG_SignificanceUpdate);
+DEFINE_STAT(STAT_RPG_BatchedTick);
+DEFINE_STAT(STAT_RPG_BatchedTickDispatch);
+DEFINE_STAT(STAT_RPG_MissileHomingBatch);
+DEFINE_STAT(STAT_RPG_PerceptionBatch);
+DEFINE_STAT(STAT_RPG_PatrolBatch);
+DEFINE_STAT(STAT_RPG_AIDecisionBatch);
+DEFINE_STAT(STAT_RPG_TargetSearches);
+DEFINE_STAT(STAT_RPG_TargetSearchCandidates);
+DEFINE_STAT(STAT_RPG_LiveProjectiles);
+DEFINE_STAT(STAT_RPG_AvoidedSaves);
+DEFINE_STAT(STAT_RPG_AnimationSignificanceUpdates);
+DEFINE_STAT(STAT_RPG_HandSocketRefreshes);
+DEFINE_STAT(STAT_RPG_SignificanceActors);
+DEFINE_STAT(STAT_RPG_SignificanceTierChanges);
+DEFINE_STAT(STAT_RPG_SimplifiedMovers);
+DEFINE_STAT(STAT_RPG_BatchedTickItems);
+DEFINE_STAT(STAT_RPG_TickingProjectiles);
+DEFINE_STAT(STAT_RPG_SaveGameSize);
+
+UE_TRACE_CHANNEL_DEFINE(RPGChannel);
+
+UE_TRACE_EVENT_BEGIN(ActionRPG, TargetSearch)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, CandidateCount)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ActionRPG, LiveProjectiles)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(int32, Count)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ActionRPG, SaveGameSize)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, NumBytes)
+	UE_TRACE_EVENT_FIELD(bool, bLoading)
+UE_TRACE_EVENT_END()
+
+namespace RPGStats
+{
+	/** Projectiles are spawned and destroyed on the game thread, this is only written from there */
+	static int32 LiveProjectileCount = 0;
+
+	void RecordTargetSearch(int32 CandidateCount)
+	{
+		INC_DWORD_STAT(STAT_RPG_TargetSearches);
+		INC_DWORD_STAT_BY(STAT_RPG_TargetSearchCandidates, CandidateCount);
+
+		UE_TRACE_LOG(ActionRPG, TargetSearch, RPGChannel)
+			<< TargetSearch.Cycle(FPlatformTime::Cycles64())
+			<< TargetSearch.CandidateCount((uint32)CandidateCount);
+	}
+
+	static void TraceLiveProjectiles()
+	{
+		UE_TRACE_LOG(ActionRPG, LiveProjectiles, RPGChannel)
+			<< LiveProjectiles.Cycle(FPlatformTime::Cycles64())
+			<< LiveProjectiles.Count(LiveProjectileCount);
+	}
+
+	void RecordProjectileSpawned()
+	{
+		LiveProjectileCount++;
+		INC_DWORD_STAT(STAT_RPG_LiveProjectiles);
+		TraceLiveProjectiles();
+	}
+
+	void RecordProjectileDestroyed()
+	{
+		LiveProjectileCount--;
+		DEC_DWORD_STAT(STAT_RPG_LiveProjectiles);
+		TraceLiveProjectiles();
+	}
+
+	void RecordSaveGameSize(int64 NumBytes, bool bLoading)
+	{
+		SET_MEMORY_STAT(STAT_RPG_SaveGameSize, NumBytes);
+
+		UE_TRACE_LOG(ActionRPG, SaveGameSize, RPGChannel)
+			<< SaveGameSize.Cycle(FPlatformTime::Cycles64())
+			<< SaveGameSize.NumBytes((uint64)NumBytes)
+			<< SaveGameSize.bLoading(bLoading);
+	}
+}
@@ -0,0 +1,67 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGAssetManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRPGAssetManagerSnapshotTest, "ActionRPG.AssetManager.PrimaryAssetSnapshot", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FRPGAssetManagerSnapshotTest::RunTest(const FString& Parameters)
+{
+	URPGAssetManager& AssetManager = URPGAssetManager::Get();
+
+	FSHAHash SnapshotKey;
+	FSHA1::HashBuffer(TEXT("PrimaryAssetSnapshotTest"), sizeof(TEXT("PrimaryAssetSnapshotTest")), SnapshotKey.Hash);
+
+	if (!TestTrue(TEXT("Wrote snapshot"), AssetManager.SavePrimaryAssetSnapshot(SnapshotKey)))
+	{
+		return false;
+	}
+
+	TMap<FPrimaryAssetType, TArray<FAssetData>> SnapshotAssets;
+	TestFalse(TEXT("Other key is stale"), URPGAssetManager::ReadPrimaryAssetSnapshot(FSHAHash(), SnapshotAssets));
+	const bool bRead = URPGAssetManager::ReadPrimaryAssetSnapshot(SnapshotKey, SnapshotAssets);
+
+	// The editor always scans, a snapshot written here would only make the next game boot rescan anyway
+	URPGAssetManager::DeletePrimaryAssetSnapshot();
+
+	if (!TestTrue(TEXT("Read snapshot"), bRead))
+	{
+		return false;
+	}
+
+	const FPrimaryAssetType ItemTypes[] = { URPGAssetManager::PotionItemType, URPGAssetManager::SkillItemType, URPGAssetManager::TokenItemType, URPGAssetManager::WeaponItemType };
+	for (const FPrimaryAssetType& ItemType : ItemTypes)
+	{
+		TArray<FAssetData> ScannedAssets;
+		AssetManager.GetPrimaryAssetDataList(ItemType, ScannedAssets);
+
+		const TArray<FAssetData>* TypeAssets = SnapshotAssets.Find(ItemType);
+		if (!TestNotNull(FString::Printf(TEXT("%s in snapshot"), *ItemType.ToString()), TypeAssets))
+		{
+			continue;
+		}
+		TestEqual(FString::Printf(TEXT("%s count"), *ItemType.ToString()), TypeAssets->Num(), ScannedAssets.Num());
+
+		// Registering from the snapshot has to see the same asset data the registry query returned
+		int32 MismatchedAssets = 0;
+		for (const FAssetData& ScannedAsset : ScannedAssets)
+		{
+			const FAssetData* SnapshotAsset = TypeAssets->FindByPredicate([&ScannedAsset](const FAssetData& AssetData) { return AssetData.GetSoftObjectPath() == ScannedAsset.GetSoftObjectPath(); });
+			const int32 NumScannedBundles = ScannedAsset.TaggedAssetBundles.IsValid() ? ScannedAsset.TaggedAssetBundles->Bundles.Num() : 0;
+			const int32 NumSnapshotBundles = SnapshotAsset && SnapshotAsset->TaggedAssetBundles.IsValid() ? SnapshotAsset->TaggedAssetBundles->Bundles.Num() : 0;
+
+			if (!SnapshotAsset || SnapshotAsset->AssetClassPath != ScannedAsset.AssetClassPath || SnapshotAsset->TagsAndValues.Num() != ScannedAsset.TagsAndValues.Num()
+				|| NumSnapshotBundles != NumScannedBundles || AssetManager.ExtractPrimaryAssetIdFromData(*SnapshotAsset, ItemType) != AssetManager.ExtractPrimaryAssetIdFromData(ScannedAsset, ItemType))
+			{
+				MismatchedAssets++;
+			}
+		}
+		TestEqual(FString::Printf(TEXT("%s mismatched assets"), *ItemType.ToString()), MismatchedAssets, 0);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
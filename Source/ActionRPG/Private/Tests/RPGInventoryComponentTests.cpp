@@ -0,0 +1,140 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Items/RPGInventoryComponent.h"
+#include "Items/RPGPotionItem.h"
+#include "RPGAssetManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRPGInventoryComponentReplicatedItemsTest, "ActionRPG.Inventory.ReplicatedItems", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FRPGInventoryComponentReplicatedItemsTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumItems = 2000;
+
+	URPGInventoryComponent* Inventory = NewObject<URPGInventoryComponent>(GetTransientPackage());
+
+	TArray<URPGItem*> Items;
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ItemIndex++)
+	{
+		URPGItem* Item = NewObject<URPGPotionItem>(GetTransientPackage(), FName(*FString::Printf(TEXT("ReplicatedItem_%d"), ItemIndex)));
+		Items.Add(Item);
+		Inventory->SetReplicatedItem(Item, FRPGItemData(1, 1));
+	}
+	TestEqual(TEXT("Added items"), Inventory->GetNumReplicatedItems(), NumItems);
+
+	// Removing swaps the last entry into the hole, every other index has to follow it
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ItemIndex++)
+	{
+		if (ItemIndex % 3 == 0)
+		{
+			Inventory->SetReplicatedItem(Items[ItemIndex], FRPGItemData());
+		}
+		else
+		{
+			Inventory->SetReplicatedItem(Items[ItemIndex], FRPGItemData(ItemIndex % 99 + 1, 2));
+		}
+	}
+
+	int32 WrongEntries = 0;
+	int32 RemainingItems = 0;
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ItemIndex++)
+	{
+		const FRPGReplicatedItemEntry* Entry = Inventory->FindReplicatedItem(Items[ItemIndex]->GetPrimaryAssetId());
+		if (ItemIndex % 3 == 0)
+		{
+			WrongEntries += Entry ? 1 : 0;
+		}
+		else
+		{
+			RemainingItems++;
+			if (!Entry || Entry->ItemId != Items[ItemIndex]->GetPrimaryAssetId() || Entry->ItemData != FRPGItemData(ItemIndex % 99 + 1, 2))
+			{
+				WrongEntries++;
+			}
+		}
+	}
+	TestEqual(TEXT("Wrong entries"), WrongEntries, 0);
+	TestEqual(TEXT("Remaining items"), Inventory->GetNumReplicatedItems(), RemainingItems);
+
+	Inventory->ClearReplicatedInventory();
+	TestEqual(TEXT("Cleared items"), Inventory->GetNumReplicatedItems(), 0);
+	TestNull(TEXT("Cleared lookup"), Inventory->FindReplicatedItem(Items[1]->GetPrimaryAssetId()));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRPGInventoryComponentSyncTest, "ActionRPG.Inventory.SyncReplicatedInventory", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FRPGInventoryComponentSyncTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumItems = 50;
+
+	URPGInventoryComponent* Inventory = NewObject<URPGInventoryComponent>(GetTransientPackage());
+
+	TArray<URPGItem*> Items;
+	TMap<URPGItem*, FRPGItemData> InventoryData;
+	TMap<FRPGItemSlot, URPGItem*> SlottedItems;
+	for (int32 ItemIndex = 0; ItemIndex < NumItems + 1; ItemIndex++)
+	{
+		Items.Add(NewObject<URPGPotionItem>(GetTransientPackage(), FName(*FString::Printf(TEXT("SyncedItem_%d"), ItemIndex))));
+	}
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ItemIndex++)
+	{
+		InventoryData.Add(Items[ItemIndex], FRPGItemData(1, 1));
+	}
+	SlottedItems.Add(FRPGItemSlot(URPGAssetManager::PotionItemType, 0), Items[0]);
+
+	Inventory->SyncReplicatedInventory(InventoryData, SlottedItems);
+	TestEqual(TEXT("Initial items"), Inventory->GetNumReplicatedItems(), NumItems);
+
+	// The replication key is what the delta serializer compares against each client's last acked state
+	TMap<FPrimaryAssetId, int32> ReplicationKeys;
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ItemIndex++)
+	{
+		const FRPGReplicatedItemEntry* Entry = Inventory->FindReplicatedItem(Items[ItemIndex]->GetPrimaryAssetId());
+		ReplicationKeys.Add(Items[ItemIndex]->GetPrimaryAssetId(), Entry ? Entry->ReplicationKey : INDEX_NONE);
+	}
+
+	// Reload with one item changed, one removed and one added
+	URPGItem* ChangedItem = Items[1];
+	URPGItem* RemovedItem = Items[2];
+	URPGItem* AddedItem = Items[NumItems];
+	InventoryData.Add(ChangedItem, FRPGItemData(5, 1));
+	InventoryData.Remove(RemovedItem);
+	InventoryData.Add(AddedItem, FRPGItemData(1, 1));
+
+	Inventory->SyncReplicatedInventory(InventoryData, SlottedItems);
+	TestEqual(TEXT("Synced items"), Inventory->GetNumReplicatedItems(), NumItems);
+
+	int32 ResentItems = 0;
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ItemIndex++)
+	{
+		URPGItem* Item = Items[ItemIndex];
+		if (Item == ChangedItem || Item == RemovedItem)
+		{
+			continue;
+		}
+
+		const FRPGReplicatedItemEntry* Entry = Inventory->FindReplicatedItem(Item->GetPrimaryAssetId());
+		if (!Entry || Entry->ReplicationKey != ReplicationKeys.FindChecked(Item->GetPrimaryAssetId()))
+		{
+			ResentItems++;
+		}
+	}
+	TestEqual(TEXT("Unchanged items marked dirty"), ResentItems, 0);
+
+	const FRPGReplicatedItemEntry* ChangedEntry = Inventory->FindReplicatedItem(ChangedItem->GetPrimaryAssetId());
+	if (TestNotNull(TEXT("Changed item"), ChangedEntry))
+	{
+		TestNotEqual(TEXT("Changed item marked dirty"), ChangedEntry->ReplicationKey, ReplicationKeys.FindChecked(ChangedItem->GetPrimaryAssetId()));
+		TestTrue(TEXT("Changed item data"), ChangedEntry->ItemData == FRPGItemData(5, 1));
+	}
+	TestNull(TEXT("Removed item"), Inventory->FindReplicatedItem(RemovedItem->GetPrimaryAssetId()));
+	TestNotNull(TEXT("Added item"), Inventory->FindReplicatedItem(AddedItem->GetPrimaryAssetId()));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
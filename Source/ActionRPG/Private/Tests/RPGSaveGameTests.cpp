@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGSaveGame.h"
+#include "RPGAssetManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryReader.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRPGSaveGameInventoryRoundTripTest, "ActionRPG.SaveGame.InventoryRoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FRPGSaveGameInventoryRoundTripTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumItems = 10000;
+	const FPrimaryAssetType ItemTypes[] = { URPGAssetManager::PotionItemType, URPGAssetManager::SkillItemType, URPGAssetManager::TokenItemType, URPGAssetManager::WeaponItemType };
+
+	URPGSaveGame* SaveGame = Cast<URPGSaveGame>(UGameplayStatics::CreateSaveGameObject(URPGSaveGame::StaticClass()));
+	if (!TestNotNull(TEXT("Created save game"), SaveGame))
+	{
+		return false;
+	}
+
+	SaveGame->UserId = TEXT("RoundTripUser");
+	SaveGame->JournalGeneration = 7;
+
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ItemIndex++)
+	{
+		const FPrimaryAssetId ItemId(ItemTypes[ItemIndex % UE_ARRAY_COUNT(ItemTypes)], FName(*FString::Printf(TEXT("Item_%d"), ItemIndex)));
+		SaveGame->InventoryData.Add(ItemId, FRPGItemData(ItemIndex % 99 + 1, ItemIndex % 10 + 1));
+	}
+
+	for (int32 SlotNumber = 0; SlotNumber < 3; SlotNumber++)
+	{
+		const FPrimaryAssetId ItemId(URPGAssetManager::WeaponItemType, FName(*FString::Printf(TEXT("Item_%d"), SlotNumber * 4 + 3)));
+		SaveGame->SlottedItems.Add(FRPGItemSlot(URPGAssetManager::WeaponItemType, SlotNumber), ItemId);
+	}
+
+	// An emptied slot keeps an invalid item id
+	SaveGame->SlottedItems.Add(FRPGItemSlot(URPGAssetManager::SkillItemType, 0), FPrimaryAssetId());
+
+	TArray<uint8> SaveData;
+	if (!TestTrue(TEXT("Saved to memory"), UGameplayStatics::SaveGameToMemory(SaveGame, SaveData)))
+	{
+		return false;
+	}
+
+	URPGSaveGame* LoadedGame = Cast<URPGSaveGame>(UGameplayStatics::LoadGameFromMemory(SaveData));
+	if (!TestNotNull(TEXT("Loaded from memory"), LoadedGame))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("UserId"), LoadedGame->UserId, SaveGame->UserId);
+	TestEqual(TEXT("JournalGeneration"), LoadedGame->JournalGeneration, SaveGame->JournalGeneration);
+	TestEqual(TEXT("Item count"), LoadedGame->InventoryData.Num(), SaveGame->InventoryData.Num());
+	TestEqual(TEXT("Slot count"), LoadedGame->SlottedItems.Num(), SaveGame->SlottedItems.Num());
+
+	int32 MismatchedItems = 0;
+	for (const TPair<FPrimaryAssetId, FRPGItemData>& ItemPair : SaveGame->InventoryData)
+	{
+		const FRPGItemData* LoadedData = LoadedGame->InventoryData.Find(ItemPair.Key);
+		if (!LoadedData || *LoadedData != ItemPair.Value)
+		{
+			MismatchedItems++;
+		}
+	}
+	TestEqual(TEXT("Mismatched items"), MismatchedItems, 0);
+
+	for (const TPair<FRPGItemSlot, FPrimaryAssetId>& SlotPair : SaveGame->SlottedItems)
+	{
+		const FPrimaryAssetId* LoadedItemId = LoadedGame->SlottedItems.Find(SlotPair.Key);
+		TestTrue(FString::Printf(TEXT("Slot %s %d"), *SlotPair.Key.ItemType.ToString(), SlotPair.Key.SlotNumber), LoadedItemId && *LoadedItemId == SlotPair.Value);
+	}
+
+	// A second round trip from the loaded object has to produce the same file
+	TArray<uint8> ResaveData;
+	UGameplayStatics::SaveGameToMemory(LoadedGame, ResaveData);
+	TestEqual(TEXT("Resaved size"), ResaveData.Num(), SaveData.Num());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRPGSaveGameTaggedOnlyLoadTest, "ActionRPG.SaveGame.TaggedOnlyLoad", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FRPGSaveGameTaggedOnlyLoadTest::RunTest(const FString& Parameters)
+{
+	URPGSaveGame* SaveGame = Cast<URPGSaveGame>(UGameplayStatics::CreateSaveGameObject(URPGSaveGame::StaticClass()));
+	SaveGame->UserId = TEXT("TaggedOnlyUser");
+	SaveGame->InventoryData.Add(FPrimaryAssetId(URPGAssetManager::PotionItemType, TEXT("Item_0")), FRPGItemData(3, 1));
+	SaveGame->SlottedItems.Add(FRPGItemSlot(URPGAssetManager::PotionItemType, 0), FPrimaryAssetId(URPGAssetManager::PotionItemType, TEXT("Item_0")));
+
+	TArray<uint8> SaveData;
+	if (!TestTrue(TEXT("Saved to memory"), UGameplayStatics::SaveGameToMemory(SaveGame, SaveData)))
+	{
+		return false;
+	}
+
+	// Cut the save where the footer says the slot section starts, the way FRPGSaveGameReader hands it to LoadGameFromMemory
+	const int64 FooterSize = sizeof(int64) * 2 + sizeof(uint32);
+	FMemoryReader FooterReader(SaveData);
+	FooterReader.Seek(SaveData.Num() - FooterSize);
+	int64 SlotsOffset = 0;
+	int64 ItemsOffset = 0;
+	uint32 FooterMagic = 0;
+	FooterReader << SlotsOffset << ItemsOffset << FooterMagic;
+
+	if (!TestEqual(TEXT("Footer magic"), FooterMagic, 0x49475052u) || !TestTrue(TEXT("Slots offset"), SlotsOffset > 0 && SlotsOffset < SaveData.Num()))
+	{
+		return false;
+	}
+
+	TArray<uint8> TaggedData(SaveData.GetData(), (int32)SlotsOffset);
+	URPGSaveGame* LoadedGame = Cast<URPGSaveGame>(UGameplayStatics::LoadGameFromMemory(TaggedData));
+	if (!TestNotNull(TEXT("Loaded tagged part"), LoadedGame))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("UserId"), LoadedGame->UserId, SaveGame->UserId);
+	TestEqual(TEXT("Item count"), LoadedGame->InventoryData.Num(), 0);
+	TestEqual(TEXT("Slot count"), LoadedGame->SlottedItems.Num(), 0);
+
+	// A full load right after must still read the inventory
+	URPGSaveGame* FullGame = Cast<URPGSaveGame>(UGameplayStatics::LoadGameFromMemory(SaveData));
+	TestTrue(TEXT("Full load has the inventory"), FullGame && FullGame->InventoryData.Num() == 1 && FullGame->SlottedItems.Num() == 1);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RPGSaveJournal.h"
+#include "RPGSaveGame.h"
+#include "RPGAssetManager.h"
+#include "HAL/FileManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRPGSaveJournalRecordsDuringSaveTest, "ActionRPG.SaveJournal.RecordsDuringSave", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FRPGSaveJournalRecordsDuringSaveTest::RunTest(const FString& Parameters)
+{
+	const FString Filename = FPaths::AutomationTransientDir() / TEXT("RecordsDuringSave.journal");
+	const FPrimaryAssetId SavedItem(URPGAssetManager::PotionItemType, TEXT("SavedItem"));
+	const FPrimaryAssetId DuringSaveItem(URPGAssetManager::PotionItemType, TEXT("DuringSaveItem"));
+	const FRPGItemSlot DuringSaveSlot(URPGAssetManager::WeaponItemType, 0);
+
+	FRPGSaveJournal Journal;
+	if (!TestTrue(TEXT("Started journal"), Journal.Reset(Filename, 1)))
+	{
+		return false;
+	}
+
+	// A full save starts, the game instance drops the records it contains
+	Journal.RecordItem(SavedItem, FRPGItemData(1, 1));
+	Journal.ClearPendingRecords();
+
+	// Changes made while the save is writing are not in the snapshot
+	Journal.RecordItem(DuringSaveItem, FRPGItemData(5, 2));
+	Journal.RecordSlot(DuringSaveSlot, DuringSaveItem);
+
+	// The save finished, the same sequence as URPGGameInstanceBase::HandleAsyncSave
+	TestTrue(TEXT("Started new journal"), Journal.Reset(Filename, 2));
+	TestTrue(TEXT("Flushed"), Journal.Flush());
+	TestFalse(TEXT("Nothing left queued"), Journal.HasPendingRecords());
+
+	URPGSaveGame* SaveGame = Cast<URPGSaveGame>(UGameplayStatics::CreateSaveGameObject(URPGSaveGame::StaticClass()));
+	SaveGame->JournalGeneration = 2;
+
+	FRPGSaveJournal ReplayJournal;
+	TestEqual(TEXT("Replayed records"), ReplayJournal.Replay(Filename, SaveGame), 2);
+
+	const FRPGItemData* ItemData = SaveGame->InventoryData.Find(DuringSaveItem);
+	TestTrue(TEXT("Item recorded during the save"), ItemData && *ItemData == FRPGItemData(5, 2));
+	TestFalse(TEXT("Item from the snapshot"), SaveGame->InventoryData.Contains(SavedItem));
+
+	const FPrimaryAssetId* SlotItem = SaveGame->SlottedItems.Find(DuringSaveSlot);
+	TestTrue(TEXT("Slot recorded during the save"), SlotItem && *SlotItem == DuringSaveItem);
+
+	IFileManager::Get().Delete(*Filename, false, false, true);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -43,6 +43,10 @@ struct FRPGStateTreeTask_FireArrow : public FStateTreeTaskCommonBase
 
 	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
 	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Spawns an arrow from in front of the actor towards the target, also used when replaying batched decisions */
+	static void SpawnArrow(AActor* Actor, AActor* Target, TSubclassOf<ARPGArrowProjectile> ArrowProjectileClass);
 
 protected:
 	void FireArrow(const FInstanceDataType& InstanceData, AActor* Target) const;
@@ -42,7 +42,7 @@ struct FRPGStateTreeTask_RandomPatrol : public FStateTreeTaskCommonBase
 	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
 	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
 
-protected:
-	FVector GetRandomPatrolLocation(const FVector& Origin, float Radius, UObject* WorldContext) const;
+	/** Also used by the patrol batch, which picks the following points once the task has entered */
+	static FVector GetRandomPatrolLocation(const FVector& Origin, float Radius, UObject* WorldContext);
 };
 
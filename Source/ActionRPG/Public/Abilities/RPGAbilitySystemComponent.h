@@ -8,6 +8,7 @@
 #include "RPGAbilitySystemComponent.generated.h"
 
 class URPGGameplayAbility;
+class URPGAbilityTask_PlayMontageAndWaitForEvent;
 
 /**
  * Subclass of ability system component with game-specific data
@@ -21,6 +22,7 @@ class ACTIONRPG_API URPGAbilitySystemComponent : public UAbilitySystemComponent
 public:
 	// Constructors and overrides
 	URPGAbilitySystemComponent();
+	virtual int32 HandleGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload) override;
 
 	/** Returns a list of currently active ability instances that match the tags */
 	void GetActiveAbilitiesWithTags(const FGameplayTagContainer& GameplayTagContainer, TArray<URPGGameplayAbility*>& ActiveAbilities);
@@ -31,4 +33,34 @@ public:
 	/** Version of function in AbilitySystemGlobals that returns correct type */
 	static URPGAbilitySystemComponent* GetAbilitySystemComponentFromActor(const AActor* Actor, bool LookForComponent = false);
 
+	/**
+	 * Montage event router, gives montage tasks gameplay events without adding a tag container delegate per montage
+	 * Tasks live in reused slots and are indexed by the exact tags they listen for, so an event only costs a lookup for its
+	 * tag and each of its parents. Empty tag containers receive every event, same as AddGameplayEventTagContainerDelegate
+	 */
+
+	/** Starts routing events matching EventTags to a task, returns the slot to pass to UnregisterMontageEventTask */
+	int32 RegisterMontageEventTask(URPGAbilityTask_PlayMontageAndWaitForEvent* Task, const FGameplayTagContainer& EventTags);
+
+	/** Stops routing events to the task in a slot */
+	void UnregisterMontageEventTask(int32 Slot, const FGameplayTagContainer& EventTags);
+
+protected:
+	/** Sends an event to every registered task that listens for it or one of its parents */
+	void RouteMontageEvent(FGameplayTag EventTag, const FGameplayEventData& Payload);
+
+	/** Registered tasks by slot, free slots are null */
+	TArray<TWeakObjectPtr<URPGAbilityTask_PlayMontageAndWaitForEvent>> MontageEventTasks;
+
+	/** Slots in MontageEventTasks that can be reused */
+	TArray<int32> FreeMontageEventSlots;
+
+	/** Slots listening for each exact tag. Entries are kept when they empty, the same few tags are used over and over */
+	TMap<FGameplayTag, TArray<int32, TInlineAllocator<4>>> MontageEventTagSlots;
+
+	/** Slots listening for every event */
+	TArray<int32> MontageEventWildcardSlots;
+
+	/** Number of tasks currently registered */
+	int32 NumMontageEventTasks;
 };
\ No newline at end of file
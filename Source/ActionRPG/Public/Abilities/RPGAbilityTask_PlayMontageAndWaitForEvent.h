@@ -74,6 +74,9 @@ public:
 		bool bStopWhenAbilityEnds = true,
 		float AnimRootMotionTranslationScale = 1.f);
 
+	/** Called by the ability system component's event router when an event matching EventTags happens */
+	void HandleRoutedGameplayEvent(FGameplayTag EventTag, const FGameplayEventData& Payload);
+
 private:
 	/** Montage that is playing */
 	UPROPERTY()
@@ -108,10 +111,11 @@ private:
 	void OnMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted);
 	void OnAbilityCancelled();
 	void OnMontageEnded(UAnimMontage* Montage, bool bInterrupted);
-	void OnGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload);
 
 	FOnMontageBlendingOutStarted BlendingOutDelegate;
 	FOnMontageEnded MontageEndedDelegate;
 	FDelegateHandle CancelledHandle;
-	FDelegateHandle EventHandle;
+
+	/** Slot in the ability system component's event router, INDEX_NONE when not registered */
+	int32 EventRouterSlot;
 };
@@ -7,6 +7,7 @@
 #include "Components/SphereComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Abilities/RPGAbilityTypes.h"
+#include "RPGSignificanceSubsystem.h"
 #include "RPGArcaneMissile.generated.h"
 
 class ARPGCharacterBase;
@@ -21,6 +22,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	/** Sphere collision component */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Projectile)
@@ -65,10 +67,22 @@ public:
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
+	/** Drops the target if it is gone or too far and looks for a new one, returns the target to steer towards */
+	AActor* UpdateHomingTarget();
+
+	/** Returns the velocity after steering towards a target for DeltaTime, has no side effects so it can run on any thread */
+	static FVector CalculateHomingVelocity(const FVector& Location, const FVector& TargetLocation, const FVector& Velocity, float MaxSpeed, float HomingAcceleration, float DeltaTime);
+
+	UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
+	float GetHomingAcceleration() const { return HomingAcceleration; }
+
 private:
 	/** Find the nearest enemy target within range */
 	AActor* FindNearestTarget();
 
-	/** Update homing behavior */
+	/** Update homing behavior, only used when there is no batched tick subsystem to steer the missile */
 	void UpdateHoming(float DeltaTime);
+
+	/** Steers less often when far from every player, movement itself still ticks every frame */
+	void ApplySignificanceTier(ERPGSignificanceTier Tier);
 };
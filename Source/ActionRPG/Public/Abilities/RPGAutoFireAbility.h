@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Abilities/RPGGameplayAbility.h"
+#include "RPGAutoFireAbility.generated.h"
+
+/**
+ * Base class for abilities that fire projectiles
+ * By default every activation commits, fires one shot and ends
+ * With bAutoFire set a single activation stays active and fires at FireInterval until the input is released or StopFiring is called,
+ * reusing the cached target between shots so sustained fire does not pay for a full ability lifecycle per shot
+ * Every shot still pays its cost, and the burst stops at the first shot that can't be afforded
+ */
+UCLASS(Abstract)
+class ACTIONRPG_API URPGAutoFireAbility : public URPGGameplayAbility
+{
+	GENERATED_BODY()
+
+public:
+	URPGAutoFireAbility();
+
+	// Overrides from UGameplayAbility
+	virtual void ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData) override;
+	virtual void InputReleased(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) override;
+	virtual void EndAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateEndAbility, bool bWasCancelled) override;
+
+	/** Ends an auto fire burst, call this when the fire input is released if the ability is not bound to an input id */
+	UFUNCTION(BlueprintCallable, Category = AutoFire)
+	void StopFiring();
+
+	/** Returns true if this ability is currently in an auto fire burst */
+	UFUNCTION(BlueprintCallable, Category = AutoFire)
+	bool IsAutoFiring() const;
+
+protected:
+	/** Fires a single shot at the passed in target, which may be null. This is the per shot path and should not search for targets */
+	virtual void FireShot(AActor* Target);
+
+	/** Does a full target search, this is only called when the cached target is missing or stale */
+	virtual AActor* FindShotTarget();
+
+	/** Returns true if a cached target can still be fired at without searching again */
+	virtual bool IsShotTargetValid(AActor* Target) const;
+
+	/** If true, one activation keeps firing at FireInterval instead of firing once and ending */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = AutoFire)
+	bool bAutoFire;
+
+	/** Seconds between shots while auto firing */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = AutoFire, meta = (EditCondition = "bAutoFire", ClampMin = "0.01"))
+	float FireInterval;
+
+	/** Seconds a cached target is reused before searching again, the target is always replaced if it becomes invalid */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = AutoFire, meta = (EditCondition = "bAutoFire", ClampMin = "0.0"))
+	float TargetRefreshInterval;
+
+	/** Maximum shots in one burst, 0 fires until stopped */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = AutoFire, meta = (EditCondition = "bAutoFire", ClampMin = "0"))
+	int32 MaxBurstShots;
+
+private:
+	/** Called by the fire timer for every shot after the first */
+	void HandleFireTimer();
+
+	/** Fires one shot with the cached target, refreshing it if needed */
+	void FireAutoShot();
+
+	/** Target cached between shots of a burst */
+	TWeakObjectPtr<AActor> CachedTarget;
+
+	/** World time of the last full target search */
+	double LastTargetSearchTime;
+
+	/** Shots fired in the whole burst */
+	int32 BurstShotCount;
+
+	FTimerHandle FireTimerHandle;
+};
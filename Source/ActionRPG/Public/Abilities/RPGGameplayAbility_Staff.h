@@ -3,7 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Abilities/RPGGameplayAbility.h"
+#include "Abilities/RPGAutoFireAbility.h"
 #include "RPGHomingProjectile.h"
 #include "RPGGameplayAbility_Staff.generated.h"
 
@@ -11,20 +11,22 @@ class ARPGHomingProjectile;
 
 /**
  * Gameplay ability for staff weapons
- * Fires homing projectiles at enemies
+ * Fires homing projectiles at enemies, set bAutoFire for held fire
  */
 UCLASS()
-class ACTIONRPG_API URPGGameplayAbility_Staff : public URPGGameplayAbility
+class ACTIONRPG_API URPGGameplayAbility_Staff : public URPGAutoFireAbility
 {
 	GENERATED_BODY()
 
 public:
 	URPGGameplayAbility_Staff();
 
-	/** Actually activate ability, this is called when all checks pass */
-	virtual void ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData) override;
-
 protected:
+	// Overrides from URPGAutoFireAbility
+	virtual void FireShot(AActor* Target) override;
+	virtual AActor* FindShotTarget() override;
+	virtual bool IsShotTargetValid(AActor* Target) const override;
+
 	/** Spawns a homing projectile towards the target */
 	UFUNCTION(BlueprintCallable, Category = "Ability")
 	void SpawnHomingProjectile();
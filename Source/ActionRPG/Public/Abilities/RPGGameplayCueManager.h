@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "GameplayCueManager.h"
+#include "RPGGameplayCueManager.generated.h"
+
+struct FStreamableHandle;
+
+/**
+ * Game implementation of the gameplay cue manager
+ * When fast booting, cue notifies are not loaded at startup. They load on first use, and everything else in the cue set
+ * starts loading once the first frame is out. This is used by setting GlobalGameplayCueManagerClass in DefaultGame.ini
+ */
+UCLASS()
+class ACTIONRPG_API URPGGameplayCueManager : public UGameplayCueManager
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGGameplayCueManager() {}
+	virtual void OnCreated() override;
+	virtual bool ShouldAsyncLoadRuntimeObjectLibraries() const override;
+
+protected:
+	/** Starts loading every cue notify in the runtime cue set that is not in memory yet */
+	void LoadDeferredCueNotifies();
+
+	/** Keeps the cue notifies loaded after the first frame in memory */
+	TSharedPtr<FStreamableHandle> DeferredCueNotifyHandle;
+};
@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "GameplayModMagnitudeCalculation.h"
+#include "ScalableFloat.h"
+#include "RPGLevelMagnitudeCalculation.generated.h"
+
+/**
+ * Magnitude calculation that reads a level scaled value from the curve rows baked by URPGAssetManager
+ * Use this as the custom calculation class of a modifier instead of a plain scalable float,
+ * so spec creation and level changes index an array instead of evaluating the curve
+ */
+UCLASS()
+class ACTIONRPG_API URPGLevelMagnitudeCalculation : public UGameplayModMagnitudeCalculation
+{
+	GENERATED_BODY()
+
+public:
+	// Overrides from UGameplayModMagnitudeCalculation
+	virtual float CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const override;
+
+protected:
+	/** Value and curve row to scale by the effect level, the curve table should be listed in BakedCurveTables */
+	UPROPERTY(EditDefaultsOnly, Category = Calculation)
+	FScalableFloat Magnitude;
+};
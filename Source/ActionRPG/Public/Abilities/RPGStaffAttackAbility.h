@@ -3,27 +3,29 @@
 #pragma once
 
 #include "ActionRPG.h"
-#include "Abilities/RPGGameplayAbility.h"
+#include "Abilities/RPGAutoFireAbility.h"
 #include "RPGStaffAttackAbility.generated.h"
 
 class ARPGArcaneMissile;
 class URPGStaffItem;
 
 /**
- * Staff attack ability that fires homing arcane missiles
+ * Staff attack ability that fires homing arcane missiles, set bAutoFire for held fire
  */
 UCLASS()
-class ACTIONRPG_API URPGStaffAttackAbility : public URPGGameplayAbility
+class ACTIONRPG_API URPGStaffAttackAbility : public URPGAutoFireAbility
 {
 	GENERATED_BODY()
 
 public:
 	URPGStaffAttackAbility();
 
-	/** Actually activate ability, do not call this directly */
-	virtual void ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData) override;
-
 protected:
+	// Overrides from URPGAutoFireAbility
+	virtual void FireShot(AActor* Target) override;
+	virtual AActor* FindShotTarget() override;
+	virtual bool IsShotTargetValid(AActor* Target) const override;
+
 	/** Projectile class to spawn */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Projectile)
 	TSubclassOf<ARPGArcaneMissile> ProjectileClass;
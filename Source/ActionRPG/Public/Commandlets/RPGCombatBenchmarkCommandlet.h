@@ -0,0 +1,83 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Commandlets/Commandlet.h"
+#include "GameplayTagContainer.h"
+#include "RPGCombatBenchmarkCommandlet.generated.h"
+
+class ARPGArcherEnemy;
+class ARPGCharacterBase;
+
+/**
+ * Headless combat simulation used to measure how the ability, damage and AI code scales
+ * Spawns archers and scripted players into a world, ticks it for a fixed time and writes a JSON report
+ * Intended to run on build machines without a GPU:
+ *
+ *   UnrealEditor-Cmd ActionRPG.uproject -run=RPGCombatBenchmark -nullrhi -unattended
+ *     [-Map=/Game/Maps/ActionRPG_P] [-Enemies=32] [-Players=4] [-Duration=30] [-TickRate=30]
+ *     [-EnemyClass=/Game/...] [-PlayerClass=/Game/...] [-PlayerAbilityTags=Ability.Melee,Ability.Skill]
+ *     [-Report=Saved/Benchmark/Combat.json]
+ */
+UCLASS()
+class ACTIONRPG_API URPGCombatBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGCombatBenchmarkCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	/** Creates an empty world or loads the requested map, returns null on failure */
+	UWorld* CreateBenchmarkWorld(const FString& MapName);
+
+	/** Shuts down a world created by CreateBenchmarkWorld */
+	void DestroyBenchmarkWorld(UWorld* World);
+
+	/** Spawns enemies on a ring around the arena center and gives them their AI controller */
+	void SpawnEnemies(UWorld* World, UClass* EnemyClass, int32 Count, float Radius);
+
+	/** Spawns player characters near the arena center, each possessed by a server side player controller */
+	void SpawnPlayers(UWorld* World, UClass* PlayerClass, int32 Count);
+
+	/** Drives players and archers for one frame: face the nearest opponent and attack when possible */
+	void DriveCombat(float DeltaSeconds);
+
+	/** Writes the collected samples to a JSON file, returns false if the file could not be written */
+	bool WriteReport(const FString& ReportPath, const TArray<float>& FrameTimes) const;
+
+	/** Spawned actors, kept so scripted input does not need to search the world */
+	UPROPERTY()
+	TArray<ARPGArcherEnemy*> Enemies;
+
+	UPROPERTY()
+	TArray<ARPGCharacterBase*> Players;
+
+	/** Ability tags the scripted players try to activate */
+	FGameplayTagContainer PlayerAbilityTags;
+
+	/** Seconds between scripted player ability activations */
+	float PlayerAttackInterval;
+
+	/** Time until the next scripted player attack */
+	float PlayerAttackTimer;
+
+	/** Number of actors spawned during the measured window, per class name */
+	TMap<FName, int32> SpawnCounts;
+
+	/** Settings, echoed into the report */
+	int32 NumEnemies;
+	int32 NumPlayers;
+	float Duration;
+	float TickRate;
+	FString MapName;
+
+	/** Memory and object counts taken before and after the measured window */
+	uint64 UsedPhysicalBefore;
+	uint64 UsedPhysicalAfter;
+	int32 ObjectCountBefore;
+	int32 ObjectCountAfter;
+};
@@ -0,0 +1,170 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Components/ActorComponent.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "RPGInventoryComponent.generated.h"
+
+class URPGInventoryComponent;
+struct FRPGReplicatedItemList;
+struct FRPGReplicatedSlotList;
+
+/** One replicated inventory item. Items are sent by asset id and resolved through the asset manager on the client */
+USTRUCT()
+struct ACTIONRPG_API FRPGReplicatedItemEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/** Item this entry is for */
+	UPROPERTY()
+	FPrimaryAssetId ItemId;
+
+	/** Count and level of the item */
+	UPROPERTY()
+	FRPGItemData ItemData;
+
+	// FFastArraySerializerItem callbacks, only called on clients
+	void PreReplicatedRemove(const FRPGReplicatedItemList& InArraySerializer);
+	void PostReplicatedAdd(const FRPGReplicatedItemList& InArraySerializer);
+	void PostReplicatedChange(const FRPGReplicatedItemList& InArraySerializer);
+};
+
+/** Replicated inventory items, only entries that changed are sent */
+USTRUCT()
+struct ACTIONRPG_API FRPGReplicatedItemList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FRPGReplicatedItemEntry> Entries;
+
+	/** Component that owns this list, receives the client callbacks. Not a property so it is never copied from the archetype */
+	URPGInventoryComponent* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FRPGReplicatedItemEntry, FRPGReplicatedItemList>(Entries, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FRPGReplicatedItemList> : public TStructOpsTypeTraitsBase2<FRPGReplicatedItemList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/** One replicated inventory slot, an invalid item id means the slot is empty */
+USTRUCT()
+struct ACTIONRPG_API FRPGReplicatedSlotEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/** Slot this entry is for */
+	UPROPERTY()
+	FRPGItemSlot ItemSlot;
+
+	/** Item in the slot */
+	UPROPERTY()
+	FPrimaryAssetId ItemId;
+
+	// FFastArraySerializerItem callbacks, only called on clients
+	void PostReplicatedAdd(const FRPGReplicatedSlotList& InArraySerializer);
+	void PostReplicatedChange(const FRPGReplicatedSlotList& InArraySerializer);
+};
+
+/** Replicated inventory slots, only entries that changed are sent */
+USTRUCT()
+struct ACTIONRPG_API FRPGReplicatedSlotList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FRPGReplicatedSlotEntry> Entries;
+
+	/** Component that owns this list, receives the client callbacks. Not a property so it is never copied from the archetype */
+	URPGInventoryComponent* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FRPGReplicatedSlotEntry, FRPGReplicatedSlotList>(Entries, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FRPGReplicatedSlotList> : public TStructOpsTypeTraitsBase2<FRPGReplicatedSlotList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Replicates the inventory of an ARPGPlayerControllerBase to its owning client
+ * The server controller mirrors every storage change in here, clients get the changes applied back to their controller
+ * so the usual inventory delegates fire on both sides. Bandwidth scales with the number of changes, not the inventory size
+ */
+UCLASS()
+class ACTIONRPG_API URPGInventoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGInventoryComponent();
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Server only, sets the replicated data for an item. Invalid data removes the item */
+	void SetReplicatedItem(URPGItem* Item, const FRPGItemData& ItemData);
+
+	/** Server only, sets the replicated contents of a slot */
+	void SetReplicatedSlot(const FRPGItemSlot& ItemSlot, URPGItem* Item);
+
+	/** Server only, removes all replicated items and slots */
+	void ClearReplicatedInventory();
+
+	/** Server only, makes the replicated inventory match the passed in one. Only entries that differ are marked dirty */
+	void SyncReplicatedInventory(const TMap<URPGItem*, FRPGItemData>& InventoryData, const TMap<FRPGItemSlot, URPGItem*>& SlottedItems);
+
+	/** Client only, applies everything received so far to the owning controller. Used when the controller resets its inventory */
+	void ApplyReplicatedInventory();
+
+	/** Returns the number of replicated items */
+	int32 GetNumReplicatedItems() const { return ReplicatedItems.Entries.Num(); }
+
+	/** Server only, returns the replicated entry for an item or null */
+	const FRPGReplicatedItemEntry* FindReplicatedItem(const FPrimaryAssetId& ItemId) const;
+
+protected:
+	friend struct FRPGReplicatedItemEntry;
+	friend struct FRPGReplicatedSlotEntry;
+
+	/** Called from the fast array callbacks */
+	void HandleItemReplicated(const FRPGReplicatedItemEntry& Entry, bool bRemoved);
+	void HandleSlotReplicated(const FRPGReplicatedSlotEntry& Entry);
+
+	/** Removes the replicated entry of an item if there is one */
+	void RemoveReplicatedItem(const FPrimaryAssetId& ItemId);
+
+	/** Returns the item for an id, loading it if needed */
+	URPGItem* ResolveItem(const FPrimaryAssetId& ItemId) const;
+
+	/** Returns the controller this component belongs to */
+	class ARPGPlayerControllerBase* GetOwningController() const;
+
+	/** Items owned by the player */
+	UPROPERTY(Replicated)
+	FRPGReplicatedItemList ReplicatedItems;
+
+	/** Server only, index into ReplicatedItems.Entries for each item so changes don't search the array */
+	TMap<FPrimaryAssetId, int32> ItemEntryIndices;
+
+	/** Contents of every slot */
+	UPROPERTY(Replicated)
+	FRPGReplicatedSlotList ReplicatedSlots;
+};
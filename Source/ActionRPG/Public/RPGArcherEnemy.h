@@ -17,6 +17,8 @@ class ACTIONRPG_API ARPGArcherEnemy : public ARPGCharacterBase
 
 public:
 	ARPGArcherEnemy();
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	/** Ideal distance to maintain from target */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Combat")
@@ -46,10 +48,17 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Combat")
 	float AttackCooldown;
 
+	/** Socket projectiles are fired from */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "AI|Combat")
+	FName ProjectileSocketName;
+
 	/** Fire a projectile at the target */
 	UFUNCTION(BlueprintCallable, Category = "Combat")
 	void FireProjectileAtTarget(AActor* Target);
 
+	/** Returns where projectiles spawn. The socket is only read again after the animation has updated the bones */
+	FVector GetProjectileSpawnLocation() const;
+
 	/** Check if can attack target */
 	UFUNCTION(BlueprintCallable, Category = "Combat")
 	bool CanAttackTarget(AActor* Target) const;
@@ -69,5 +78,20 @@ protected:
 
 	/** Last time we attacked */
 	float LastAttackTime;
+
+	/** Marks the cached socket transform stale, called only when the animation has actually updated the bones */
+	void HandleBoneTransformsFinalized();
+
+	/** Component space transform of ProjectileSocketName, read when a projectile needs it */
+	mutable FTransform CachedProjectileSocketTransform;
+
+	/** Handle for the bone transforms finalized delegate on the mesh */
+	FDelegateHandle BoneTransformsFinalizedHandle;
+
+	/** True if the mesh has ProjectileSocketName, resolved once in BeginPlay */
+	uint32 bHasProjectileSocket : 1;
+
+	/** True if the bones moved since CachedProjectileSocketTransform was read */
+	mutable uint32 bProjectileSocketDirty : 1;
 };
 
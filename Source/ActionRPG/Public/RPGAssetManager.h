@@ -4,9 +4,26 @@
 
 #include "ActionRPG.h"
 #include "Engine/AssetManager.h"
+#include "Misc/SecureHash.h"
 #include "RPGAssetManager.generated.h"
 
 class URPGItem;
+class UCurveTable;
+struct FScalableFloat;
+struct FStreamableHandle;
+
+/** Block of contiguous item registry ids that all share one item type */
+struct FRPGItemTypeRange
+{
+	FPrimaryAssetType ItemType;
+	int32 FirstId = 0;
+	int32 Num = 0;
+
+	bool Contains(int32 ItemId) const
+	{
+		return ItemId >= FirstId && ItemId < FirstId + Num;
+	}
+};
 
 /**
  * Game implementation of asset manager, overrides functionality and stores game-specific types
@@ -22,6 +39,8 @@ public:
 	// Constructor and overrides
 	URPGAssetManager() {}
 	virtual void StartInitialLoading() override;
+	virtual void ScanPrimaryAssetTypesFromConfig() override;
+	virtual int32 ScanPathsForPrimaryAssets(FPrimaryAssetType PrimaryAssetType, const TArray<FString>& Paths, UClass* BaseClass, bool bHasBlueprintClasses, bool bIsEditorOnly = false, bool bForceSynchronousScan = true) override;
 
 	/** Static types for items */
 	static const FPrimaryAssetType	PotionItemType;
@@ -40,5 +59,160 @@ public:
 	 * @param bDisplayWarning If true, this will log a warning if the item failed to load
 	 */
 	URPGItem* ForceLoadItem(const FPrimaryAssetId& PrimaryAssetId, bool bLogWarning = true);
+
+	/** Returns an item if it is already in memory, using the item registry when possible. This never loads */
+	URPGItem* FindLoadedItem(const FPrimaryAssetId& PrimaryAssetId) const;
+
+	/**
+	 * The item registry gives every item primary asset a small integer id, assigned at startup
+	 * Ids are contiguous per item type so type checks are range checks. They are stable for a given set of cooked items,
+	 * but not across content changes so they should not be written to save games
+	 */
+
+	/** Returns the registry id for an item, or INDEX_NONE if it is not a registered item */
+	int32 GetItemRegistryId(const FPrimaryAssetId& PrimaryAssetId) const;
+
+	/** Returns the primary asset id for a registry id */
+	FPrimaryAssetId GetRegisteredItemAssetId(int32 ItemId) const;
+
+	/** Returns the resident item for a registry id, null until the registry has finished preloading */
+	URPGItem* GetRegisteredItem(int32 ItemId) const;
+
+	/** Returns the range of registry ids used by an item type, false if the type has no items */
+	bool GetItemTypeRange(FPrimaryAssetType ItemType, FRPGItemTypeRange& OutRange) const;
+
+	/** Returns the number of registered items, ids go from 0 to this minus one */
+	int32 GetNumRegisteredItems() const { return RegisteredItemIds.Num(); }
+
+	/** Returns true once every registered item is loaded and resident */
+	bool IsItemRegistryResident() const { return bItemRegistryResident; }
+
+	/**
+	 * Returns the value of a curve table row at an integer level
+	 * Rows baked at startup are a single array index, anything else falls back to evaluating the curve
+	 */
+	float GetCurveValueAtLevel(const UCurveTable* CurveTable, FName RowName, int32 Level) const;
+
+	/** Returns a scalable float at an integer level, using the baked curve rows when possible */
+	float GetScalableFloatAtLevel(const FScalableFloat& ScalableFloat, int32 Level) const;
+
+	/**
+	 * Starts async loading everything listed in the preload manifest of a map, and releases the previous map's preload once it is in
+	 * Manifests are the [RPGMapPreload <MapName>] sections of DefaultGame.ini. This is called for every map load, before the map loads
+	 * Returns false if the map has no manifest
+	 */
+	bool PreloadMapAssets(const FString& MapName);
+
+	/** Returns progress of the current map preload from 0 to 1, 1 if nothing is loading */
+	float GetMapPreloadProgress() const;
+
+	/** Returns true once everything in the current map's manifest is in memory */
+	bool IsMapPreloadComplete() const;
+
+	/** Called when a map preload finishes */
+	FSimpleMulticastDelegate OnMapPreloadComplete;
+
+	/** Returns the highest level baked for every curve row */
+	int32 GetMaxBakedLevel() const { return MaxBakedLevel; }
+
+	/**
+	 * Primary asset snapshot, a compact binary copy of the asset data of every scanned primary asset
+	 * Game and server processes write it to Saved/AssetManager after a full scan. On the next boot the primary asset types and
+	 * rules are still set up from config as usual, but the path scans register the assets from the snapshot instead of
+	 * searching the asset registry. It is keyed on the scan config and build, plus the timestamps of the scanned directories
+	 * for uncooked content or the cooked asset registry for cooked builds, so any change rescans
+	 * Disable with bUsePrimaryAssetSnapshot in [/Script/ActionRPG.RPGAssetManager] or -NoPrimaryAssetSnapshot
+	 */
+
+	/** Writes the asset data of every registered primary asset to the snapshot */
+	bool SavePrimaryAssetSnapshot(const FSHAHash& SnapshotKey) const;
+
+	/** Reads the snapshot into asset data per type, returns false if it is missing, corrupt or was written with another key */
+	static bool ReadPrimaryAssetSnapshot(const FSHAHash& SnapshotKey, TMap<FPrimaryAssetType, TArray<FAssetData>>& OutAssets);
+
+	/** Deletes the snapshot so the next boot scans */
+	static void DeletePrimaryAssetSnapshot();
+
+protected:
+	/** Returns true if this process can skip the scan, the editor and commandlets always scan */
+	bool CanUsePrimaryAssetSnapshot() const;
+
+	/** Returns the hash a snapshot must have been written with to be used */
+	FSHAHash ComputePrimaryAssetSnapshotKey() const;
+
+	/** Assets read from the snapshot, only filled in while ScanPrimaryAssetTypesFromConfig runs */
+	TMap<FPrimaryAssetType, TArray<FAssetData>> PrimaryAssetSnapshot;
+
+	/** True while the config scan registers assets from PrimaryAssetSnapshot */
+	bool bScanningFromSnapshot = false;
+
+	/** Writes the snapshot if the scan could not use it, then builds the item registry */
+	void HandleInitialScanComplete();
+
+	/** Key of the snapshot that should be written after the scan */
+	FSHAHash PrimaryAssetSnapshotKey;
+
+	/** True if the scan ran because the snapshot was missing or stale */
+	bool bPrimaryAssetSnapshotStale = false;
+
+	/** Assigns registry ids to all scanned items and starts preloading them, called once the primary asset scan is done */
+	void BuildItemRegistry();
+
+	/** Starts loading every registered item, deferred until after the first frame when fast booting */
+	void PreloadItemRegistry();
+
+	/** Called when every registered item is in memory */
+	void HandleItemRegistryLoaded();
+
+	/** Registry id to primary asset id */
+	TArray<FPrimaryAssetId> RegisteredItemIds;
+
+	/** Primary asset id to registry id */
+	TMap<FPrimaryAssetId, int32> RegisteredItemLookup;
+
+	/** Registry id ranges for each item type */
+	TArray<FRPGItemTypeRange> ItemTypeRanges;
+
+	/** Registry id to resident item, kept referenced for the lifetime of the game */
+	UPROPERTY()
+	TArray<TObjectPtr<URPGItem>> ResidentItems;
+
+	/** Handle for the item preload */
+	TSharedPtr<FStreamableHandle> ItemRegistryHandle;
+
+	/** True once ResidentItems is filled in */
+	bool bItemRegistryResident = false;
+
+	/** Called by FCoreUObjectDelegates::PreLoadMap */
+	void HandlePreLoadMap(const FString& MapName);
+
+	/** Progress and completion callbacks of the map preload */
+	void HandleMapPreloadUpdate(TSharedRef<FStreamableHandle> Handle);
+	void HandleMapPreloadComplete();
+
+	/** Keeps the current map's preloaded assets in memory */
+	TSharedPtr<FStreamableHandle> MapPreloadHandle;
+
+	/** Replaced preload, released once the new one completes so assets shared by both maps stay loaded */
+	TSharedPtr<FStreamableHandle> PreviousMapPreloadHandle;
+
+	/**
+	 * Loads the curve tables listed under BakedCurveTables in the [/Script/ActionRPG.RPGAssetManager] section of DefaultGame.ini
+	 * and evaluates every row at levels 1 to MaxBakedLevel into BakedCurveValues. Fast boot runs this after the first frame
+	 */
+	void BakeCurveTables();
+
+	/** Curve tables that were baked, kept referenced so the row keys stay valid */
+	UPROPERTY()
+	TArray<TObjectPtr<UCurveTable>> BakedCurveTables;
+
+	/** Every baked row stored back to back, each row is MaxBakedLevel values starting at level 1 */
+	TArray<float> BakedCurveValues;
+
+	/** Offset into BakedCurveValues for each baked table and row */
+	TMap<TPair<const UCurveTable*, FName>, int32> BakedCurveRows;
+
+	/** Number of levels baked per row */
+	int32 MaxBakedLevel = 0;
 };
 
@@ -0,0 +1,409 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "RPGStats.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "UObject/ObjectKey.h"
+#include "StateTreeTypes.h"
+#include "RPGBatchedTickSubsystem.generated.h"
+
+class AAIController;
+class ARPGArcaneMissile;
+class ARPGArrowProjectile;
+
+/**
+ * Base for a manager that ticks every registered actor in one pass, instead of each actor running its own tick function
+ * Items are kept contiguous and removed by swapping with the last. Gather copies what TickItem needs from the actors on the
+ * game thread, TickItem only works on its own item so it can run on worker threads, and Apply writes results back
+ */
+template<typename ItemType>
+class TRPGBatchedTickManager
+{
+public:
+	virtual ~TRPGBatchedTickManager() = default;
+
+	/** Returns true if an actor is registered */
+	bool IsRegistered(const AActor* Actor) const
+	{
+		return ItemIndices.Contains(Actor);
+	}
+
+	/** Number of registered actors */
+	int32 Num() const
+	{
+		return Items.Num();
+	}
+
+	/** Stops ticking an actor, call from EndPlay */
+	void Unregister(const AActor* Actor)
+	{
+		int32 Index = INDEX_NONE;
+		if (!ItemIndices.RemoveAndCopyValue(Actor, Index))
+		{
+			return;
+		}
+
+		Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		ItemActors.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		if (ItemActors.IsValidIndex(Index))
+		{
+			// The last item moved into the hole
+			ItemIndices.Add(ItemActors[Index], Index);
+		}
+
+		DEC_DWORD_STAT(STAT_RPG_BatchedTickItems);
+	}
+
+	/** Gathers on the game thread, ticks every item, in parallel once there are at least ParallelThreshold, then applies on the game thread */
+	void Tick(UWorld* World, float DeltaTime, bool bAllowParallel, int32 ParallelThreshold)
+	{
+		if (Items.Num() == 0)
+		{
+			return;
+		}
+
+		{
+			RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_BatchedTickDispatch);
+			Gather(World, DeltaTime);
+		}
+
+		const bool bParallel = bAllowParallel && Items.Num() >= ParallelThreshold;
+		ParallelFor(Items.Num(), [this, DeltaTime](int32 Index)
+		{
+			TickItem(Items[Index], DeltaTime);
+		}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+		{
+			RPG_SCOPE_CYCLE_COUNTER(STAT_RPG_BatchedTickDispatch);
+			Apply(DeltaTime);
+		}
+	}
+
+protected:
+	/** Returns the item of an actor, or null */
+	ItemType* Find(const AActor* Actor)
+	{
+		const int32* Index = ItemIndices.Find(Actor);
+		return Index ? &Items[*Index] : nullptr;
+	}
+
+	const ItemType* Find(const AActor* Actor) const
+	{
+		const int32* Index = ItemIndices.Find(Actor);
+		return Index ? &Items[*Index] : nullptr;
+	}
+
+	/** Returns the item of an actor, adding a default one if it is not registered yet */
+	ItemType& FindOrAdd(const AActor* Actor)
+	{
+		if (const int32* Index = ItemIndices.Find(Actor))
+		{
+			return Items[*Index];
+		}
+
+		INC_DWORD_STAT(STAT_RPG_BatchedTickItems);
+
+		const int32 Index = Items.AddDefaulted();
+		ItemActors.Add(Actor);
+		ItemIndices.Add(Actor, Index);
+		return Items[Index];
+	}
+
+	/** Copies actor state into the items, game thread */
+	virtual void Gather(UWorld* World, float DeltaTime) {}
+
+	/** Ticks one item, may run on any thread so it must only touch the item and data copied in Gather */
+	virtual void TickItem(ItemType& Item, float DeltaTime) const = 0;
+
+	/** Writes results back to the actors, game thread */
+	virtual void Apply(float DeltaTime) {}
+
+	/** Registered items, ItemActors holds the actor of each at the same index */
+	TArray<ItemType> Items;
+	TArray<TObjectKey<AActor>> ItemActors;
+
+	/** Index into Items for each registered actor */
+	TMap<TObjectKey<AActor>, int32> ItemIndices;
+};
+
+struct FRPGMissileHomingItem
+{
+	TWeakObjectPtr<ARPGArcaneMissile> Missile;
+
+	/** Seconds between homing steps, from the missile's significance tier */
+	float TickInterval = 0.0f;
+
+	/** Time since the last homing step, which is the delta time of the next one */
+	float TimeSinceStep = 0.0f;
+
+	/** Copied in Gather for the step */
+	FVector Location = FVector::ZeroVector;
+	FVector TargetLocation = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	float MaxSpeed = 0.0f;
+	float HomingAcceleration = 0.0f;
+	float StepTime = 0.0f;
+
+	/** True if the missile steers this frame */
+	bool bStep = false;
+};
+
+/** Steers arcane missiles towards their targets, replaces the per missile actor tick */
+class ACTIONRPG_API FRPGMissileHomingBatch : public TRPGBatchedTickManager<FRPGMissileHomingItem>
+{
+public:
+	/** Starts steering a missile */
+	void Register(ARPGArcaneMissile* Missile);
+
+	/** Sets how often a missile steers, 0 steers every frame */
+	void SetTickInterval(const AActor* Missile, float TickInterval);
+
+protected:
+	virtual void Gather(UWorld* World, float DeltaTime) override;
+	virtual void TickItem(FRPGMissileHomingItem& Item, float DeltaTime) const override;
+	virtual void Apply(float DeltaTime) override;
+};
+
+struct FRPGPerceptionItem
+{
+	TWeakObjectPtr<AActor> Agent;
+
+	/** Copied in Gather */
+	FVector Location = FVector::ZeroVector;
+
+	/** Index into the batch's targets of the nearest one, INDEX_NONE if there are none */
+	int32 NearestTargetIndex = INDEX_NONE;
+
+	/** Result of the last tick */
+	TWeakObjectPtr<AActor> NearestTarget;
+	float NearestDistanceSquared = MAX_FLT;
+
+	/** False until the first tick after registering */
+	bool bPerceived = false;
+};
+
+/**
+ * Finds the nearest player character for every registered AI once per frame
+ * StateTree nodes read the result instead of each running their own search over every character in the world
+ */
+class ACTIONRPG_API FRPGPerceptionBatch : public TRPGBatchedTickManager<FRPGPerceptionItem>
+{
+public:
+	/** Starts finding targets for an agent */
+	void Register(AActor* Agent);
+
+	/**
+	 * Returns the nearest player character closer than Range from the last tick, or null if there is none
+	 * Returns false if the agent has not been perceived yet, the caller should search on its own
+	 */
+	bool FindNearestTarget(const AActor* Agent, float Range, AActor*& OutTarget) const;
+
+protected:
+	virtual void Gather(UWorld* World, float DeltaTime) override;
+	virtual void TickItem(FRPGPerceptionItem& Item, float DeltaTime) const override;
+	virtual void Apply(float DeltaTime) override;
+
+	struct FTarget
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FVector Location;
+	};
+
+	/** Player characters that can be targeted, gathered each tick */
+	TArray<FTarget, TInlineAllocator<4>> Targets;
+};
+
+struct FRPGPatrolItem
+{
+	TWeakObjectPtr<AAIController> Controller;
+	FVector PatrolLocation = FVector::ZeroVector;
+	float PatrolRadius = 0.0f;
+
+	/** Copied in Gather */
+	FVector Location = FVector::ZeroVector;
+	bool bIsMoving = false;
+
+	/** Set by TickItem when the agent arrived or stopped */
+	bool bNeedsPatrolLocation = false;
+};
+
+/** Picks new patrol points for patrolling AI once they arrive, replaces the random patrol StateTree task tick */
+class ACTIONRPG_API FRPGPatrolBatch : public TRPGBatchedTickManager<FRPGPatrolItem>
+{
+public:
+	/** Starts patrolling around the pawn of a controller, the first move must already have been requested */
+	void Register(AAIController* Controller, const FVector& PatrolLocation, float PatrolRadius);
+
+protected:
+	virtual void Gather(UWorld* World, float DeltaTime) override;
+	virtual void TickItem(FRPGPatrolItem& Item, float DeltaTime) const override;
+	virtual void Apply(float DeltaTime) override;
+};
+
+/** State shared by every StateTree task that decides in a batch */
+struct FRPGAIDecisionItem
+{
+	TWeakObjectPtr<APawn> Agent;
+	TWeakObjectPtr<AActor> Target;
+
+	/** Time since the last decision, decisions are as frequent as the agent's significance tier lets the AI think */
+	float TimeSinceDecision = 0.0f;
+
+	/** Copied before each decision, StepTime is the delta time of this decision */
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	FVector TargetLocation = FVector::ZeroVector;
+	float StepTime = 0.0f;
+	bool bIsMoving = false;
+
+	/** True if the agent decides this frame */
+	bool bDecide = false;
+
+	/** Result read by the task's Tick */
+	EStateTreeRunStatus Status = EStateTreeRunStatus::Running;
+};
+
+namespace RPGAIDecision
+{
+	/** Copies the agent and target positions, returns false if the agent does not decide this frame */
+	ACTIONRPG_API bool GatherSnapshot(FRPGAIDecisionItem& Item, float DeltaTime);
+}
+
+/**
+ * Runs a StateTree task for every registered agent in one pass on the game thread, instead of one StateTree node tick each
+ * A decision is a few compares next to the move requests, rotations and spawns it makes, so it acts on the agent right away
+ */
+template<typename ItemType>
+class TRPGAIDecisionBatch : public TRPGBatchedTickManager<ItemType>
+{
+public:
+	/** Starts deciding for an agent, returns the item so the task can copy its parameters and state in */
+	ItemType& Register(APawn* Agent, AActor* Target)
+	{
+		ItemType& Item = this->FindOrAdd(Agent);
+		Item = ItemType();
+		Item.Agent = Agent;
+		Item.Target = Target;
+		return Item;
+	}
+
+	/** Returns the status of the last decision, Running until the first one and Failed if the agent is not registered */
+	EStateTreeRunStatus GetStatus(const AActor* Agent) const
+	{
+		const ItemType* Item = this->Find(Agent);
+		return Item ? Item->Status : EStateTreeRunStatus::Failed;
+	}
+
+	/** Decides for every agent whose think interval is up, game thread */
+	void TickDecisions(float DeltaTime)
+	{
+		for (ItemType& Item : this->Items)
+		{
+			if (RPGAIDecision::GatherSnapshot(Item, DeltaTime))
+			{
+				DecideItem(Item);
+			}
+		}
+	}
+
+protected:
+	/** Decides for one agent and acts on it, the agent and target are valid */
+	virtual void DecideItem(ItemType& Item) = 0;
+
+	/** Decisions act on their agent, so they run in TickDecisions instead of the threaded tick */
+	virtual void TickItem(ItemType& Item, float DeltaTime) const override {}
+};
+
+struct FRPGChaseDecisionItem : public FRPGAIDecisionItem
+{
+	float AcceptanceRadius = 0.0f;
+};
+
+/** Keeps chasing agents moving towards their target */
+class ACTIONRPG_API FRPGChaseDecisionBatch : public TRPGAIDecisionBatch<FRPGChaseDecisionItem>
+{
+protected:
+	virtual void DecideItem(FRPGChaseDecisionItem& Item) override;
+};
+
+struct FRPGFireArrowDecisionItem : public FRPGAIDecisionItem
+{
+	TSubclassOf<ARPGArrowProjectile> ArrowProjectileClass;
+	float AttackCooldown = 0.0f;
+	float TimeSinceLastAttack = 0.0f;
+};
+
+/** Turns archers towards their target and fires when the cooldown is up */
+class ACTIONRPG_API FRPGFireArrowDecisionBatch : public TRPGAIDecisionBatch<FRPGFireArrowDecisionItem>
+{
+protected:
+	virtual void DecideItem(FRPGFireArrowDecisionItem& Item) override;
+};
+
+struct FRPGRetreatDecisionItem : public FRPGAIDecisionItem
+{
+	FVector RetreatLocation = FVector::ZeroVector;
+	float RetreatDistance = 0.0f;
+};
+
+/** Finishes the retreat once the agent is far enough from its target or reached the retreat location */
+class ACTIONRPG_API FRPGRetreatDecisionBatch : public TRPGAIDecisionBatch<FRPGRetreatDecisionItem>
+{
+protected:
+	virtual void DecideItem(FRPGRetreatDecisionItem& Item) override;
+};
+
+/**
+ * Ticks missiles, AI perception, patrols and StateTree task decisions in one batch per type each frame, instead of one tick
+ * per actor or StateTree node. Work that only reads copied data runs with ParallelFor when a batch is large enough
+ */
+UCLASS(Config = Game)
+class ACTIONRPG_API URPGBatchedTickSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGBatchedTickSubsystem();
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Returns the subsystem of an object's world, null outside game worlds */
+	static URPGBatchedTickSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Returns the subsystem if StateTree task decisions are batched, null if tasks should decide in their own Tick */
+	static URPGBatchedTickSubsystem* GetForAIDecisions(const UObject* WorldContextObject);
+
+	/** Batches, register with these from BeginPlay or EnterState and unregister from EndPlay or ExitState */
+	FRPGMissileHomingBatch& GetMissileHoming() { return MissileHoming; }
+	FRPGPerceptionBatch& GetPerception() { return Perception; }
+	FRPGPatrolBatch& GetPatrol() { return Patrol; }
+	FRPGChaseDecisionBatch& GetChaseDecisions() { return ChaseDecisions; }
+	FRPGFireArrowDecisionBatch& GetFireArrowDecisions() { return FireArrowDecisions; }
+	FRPGRetreatDecisionBatch& GetRetreatDecisions() { return RetreatDecisions; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	FRPGMissileHomingBatch MissileHoming;
+	FRPGPerceptionBatch Perception;
+	FRPGPatrolBatch Patrol;
+	FRPGChaseDecisionBatch ChaseDecisions;
+	FRPGFireArrowDecisionBatch FireArrowDecisions;
+	FRPGRetreatDecisionBatch RetreatDecisions;
+
+	/** If true, chase, fire arrow and retreat tasks decide in batches and their Tick only reads the result */
+	UPROPERTY(Config)
+	bool bBatchedAIDecisions;
+
+	/** If true, batches with at least ParallelBatchThreshold items tick on worker threads. StateTree task decisions always tick on the game thread */
+	UPROPERTY(Config)
+	bool bParallelBatchedTicks;
+
+	/** Smallest batch worth splitting across threads */
+	UPROPERTY(Config)
+	int32 ParallelBatchThreshold;
+};
@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ----------------------------------------------------------------------------------------------------------------
+// Lightweight timing used by the combat benchmark commandlet to split frame time between gameplay subsystems
+// Scopes are compiled out of shipping builds and cost a single branch when no benchmark is running
+// Only game thread scopes are timed, scopes on worker threads are ignored and their time shows up in the game thread
+// scope that waits for them. Nested scopes of the same bucket only count the outermost one
+// ----------------------------------------------------------------------------------------------------------------
+
+#ifndef WITH_RPG_BENCHMARK
+#define WITH_RPG_BENCHMARK !UE_BUILD_SHIPPING
+#endif
+
+/** Gameplay subsystems that are timed separately by the benchmark */
+enum class ERPGBenchmarkBucket : uint8
+{
+	/** StateTree tasks and conditions */
+	AITick,
+	/** Projectile movement, homing and hit handling */
+	Projectile,
+	/** Damage executions run by gameplay effects */
+	GameplayEffectExecute,
+	/** Attribute set callbacks and the character notifications they trigger */
+	AttributeCallback,
+
+	Num
+};
+
+/** Accumulates time per bucket per frame, and keeps one sample per frame for percentiles */
+class ACTIONRPG_API FRPGBenchmark
+{
+public:
+	/** Clears all samples and starts recording */
+	static void Start();
+
+	/** Stops recording, samples are kept until the next Start */
+	static void Stop();
+
+	/** Returns true while recording */
+	static bool IsActive() { return bActive; }
+
+	/** Adds time to the current frame of a bucket, game thread only */
+	static void AddTime(ERPGBenchmarkBucket Bucket, double Seconds);
+
+	/** Enters or leaves a scope of a bucket, both return true for the outermost scope */
+	static bool PushScope(ERPGBenchmarkBucket Bucket) { return ScopeDepths[(int32)Bucket]++ == 0; }
+	static bool PopScope(ERPGBenchmarkBucket Bucket) { return --ScopeDepths[(int32)Bucket] == 0; }
+
+	/** Closes the current frame, pushing one sample per bucket */
+	static void EndFrame();
+
+	/** Per frame totals in milliseconds for a bucket */
+	static const TArray<float>& GetFrameSamples(ERPGBenchmarkBucket Bucket);
+
+	/** Number of scopes recorded for a bucket since Start */
+	static int64 GetCallCount(ERPGBenchmarkBucket Bucket);
+
+	/** Stable lower case name used in reports */
+	static const TCHAR* GetBucketName(ERPGBenchmarkBucket Bucket);
+
+private:
+	static bool bActive;
+	static double FrameSeconds[(int32)ERPGBenchmarkBucket::Num];
+	static int64 CallCounts[(int32)ERPGBenchmarkBucket::Num];
+	static TArray<float> FrameSamples[(int32)ERPGBenchmarkBucket::Num];
+	static int32 ScopeDepths[(int32)ERPGBenchmarkBucket::Num];
+};
+
+/** Times the enclosing scope into a benchmark bucket, if a benchmark is running and this is the game thread */
+struct FRPGBenchmarkScope
+{
+	explicit FRPGBenchmarkScope(ERPGBenchmarkBucket InBucket)
+		: Bucket(InBucket)
+		, StartTime(0.0)
+		, bPushed(FRPGBenchmark::IsActive() && IsInGameThread())
+	{
+		if (bPushed && FRPGBenchmark::PushScope(Bucket))
+		{
+			StartTime = FPlatformTime::Seconds();
+		}
+	}
+
+	~FRPGBenchmarkScope()
+	{
+		if (bPushed && FRPGBenchmark::PopScope(Bucket) && StartTime > 0.0)
+		{
+			FRPGBenchmark::AddTime(Bucket, FPlatformTime::Seconds() - StartTime);
+		}
+	}
+
+private:
+	ERPGBenchmarkBucket Bucket;
+	double StartTime;
+	bool bPushed;
+};
+
+#if WITH_RPG_BENCHMARK
+#define RPG_BENCHMARK_SCOPE(Bucket) FRPGBenchmarkScope PREPROCESSOR_JOIN(RPGBenchmarkScope_, __LINE__)(ERPGBenchmarkBucket::Bucket)
+#else
+#define RPG_BENCHMARK_SCOPE(Bucket)
+#endif
@@ -17,7 +17,7 @@ class URPGBlueprintLibrary : public UBlueprintFunctionLibrary
 	GENERATED_UCLASS_BODY()
 
 public:
-	/** Show the native loading screen, such as on a map transfer. If bPlayUntilStopped is false, it will be displayed for PlayTime and automatically stop */
+	/** Show the native loading screen, such as on a map transfer. If bPlayUntilStopped is false, it stops once the map and all loading tasks are done, but not before PlayTime */
 	UFUNCTION(BlueprintCallable, Category = Loading)
 	static void PlayLoadingScreen(bool bPlayUntilStopped, float PlayTime);
 
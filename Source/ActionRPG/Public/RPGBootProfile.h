@@ -0,0 +1,62 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// ----------------------------------------------------------------------------------------------------------------
+// Boot phase timing, from process start to the first frame the local player can play
+// Phases are timestamped relative to process start and written to Saved/Logs/StartupReport.json once boot is over
+// The report is always written for -nullrhi runs so CI can track boot time, -RPGStartupReport=<path> writes it anywhere
+// Fast boot (-RPGFastBoot, or bFastBoot in [/Script/ActionRPG.RPGAssetManager]) defers non essential startup work
+// until the first world frame has been rendered
+// ----------------------------------------------------------------------------------------------------------------
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+namespace RPGBoot
+{
+	/** Starts timing a boot phase. Phases that start after the report has been written are ignored */
+	ACTIONRPG_API void BeginPhase(FName Phase);
+
+	/** Stops timing a boot phase, does nothing if the phase was never started */
+	ACTIONRPG_API void EndPhase(FName Phase);
+
+	/** Records a single point in time, such as the first frame */
+	ACTIONRPG_API void MarkEvent(FName Event);
+
+	/** Returns true if non essential startup work should wait for the first frame */
+	ACTIONRPG_API bool IsFastBoot();
+
+	/** Returns true once the first world frame has finished */
+	ACTIONRPG_API bool HasReachedFirstFrame();
+
+	/** Runs work now, or after the first world frame when fast booting. Must be called on the game thread */
+	ACTIONRPG_API void DeferUntilFirstFrame(TFunction<void()>&& Work);
+
+	/** Called when a game map has loaded, marks the first world frame at the end of the next frame */
+	ACTIONRPG_API void NotifyMapLoaded(UWorld* World);
+
+	/** Called when the local player can play, marks the first interactive frame and writes the report */
+	ACTIONRPG_API void NotifyInteractive();
+
+	/** Times a phase for the lifetime of the scope */
+	struct FScopedPhase
+	{
+		explicit FScopedPhase(FName InPhase)
+			: Phase(InPhase)
+		{
+			BeginPhase(Phase);
+		}
+
+		~FScopedPhase()
+		{
+			EndPhase(Phase);
+		}
+
+	private:
+		FName Phase;
+	};
+}
+
+#define RPG_BOOT_PHASE_SCOPE(Phase) RPGBoot::FScopedPhase ANONYMOUS_VARIABLE(RPGBootPhase)(Phase)
@@ -10,10 +10,46 @@
 #include "Abilities/RPGAbilitySystemComponent.h"
 #include "Abilities/RPGAttributeSet.h"
 #include "GenericTeamAgentInterface.h"
+#include "RPGSignificanceSubsystem.h"
 #include "RPGCharacterBase.generated.h"
 
 class URPGGameplayAbility;
 class UGameplayEffect;
+class ARPGCharacterBase;
+class USkeletalMeshComponentBudgeted;
+
+/** Health, mana and move speed changes accumulated over a frame, broadcast once per character */
+struct ACTIONRPG_API FRPGAttributeChangeSet
+{
+	/** Summed deltas, only meaningful if the matching changed flag is set. Unknown deltas are counted as 0 */
+	float HealthDelta = 0.f;
+	float ManaDelta = 0.f;
+	float MoveSpeedDelta = 0.f;
+
+	bool bHealthChanged = false;
+	bool bManaChanged = false;
+	bool bMoveSpeedChanged = false;
+
+	/** Union of the tags of every event that contributed to this change set */
+	FGameplayTagContainer EventTags;
+
+	/** Returns true if anything was recorded since the last reset */
+	bool HasChanges() const
+	{
+		return bHealthChanged || bManaChanged || bMoveSpeedChanged;
+	}
+
+	void Reset()
+	{
+		*this = FRPGAttributeChangeSet();
+	}
+};
+
+/** Native attribute bus, see ARPGCharacterBase::OnAttributesChangedNative */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAttributesChangedNative, const FRPGAttributeChangeSet&);
+
+/** Native per-hit damage callback, parameters match ARPGCharacterBase::OnDamaged */
+DECLARE_MULTICAST_DELEGATE_FiveParams(FOnCharacterDamagedNative, float, const FHitResult&, const FGameplayTagContainer&, ARPGCharacterBase*, AActor*);
 
 /** Base class for Character, Designed to be blueprinted */
 UCLASS()
@@ -23,10 +59,14 @@ class ACTIONRPG_API ARPGCharacterBase : public ACharacter, public IAbilitySystem
 
 public:
 	// Constructor and overrides
-	ARPGCharacterBase();
+	ARPGCharacterBase(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 	virtual void PossessedBy(AController* NewController) override;
+	virtual void NotifyControllerChanged() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void UnPossessed() override;
 	virtual void OnRep_Controller() override;
+	virtual void PostInitializeComponents() override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	// Implement IAbilitySystemInterface
@@ -56,7 +96,7 @@ public:
 	UFUNCTION(BlueprintCallable)
 	virtual int32 GetCharacterLevel() const;
 
-	/** Modifies the character level, this may change abilities. Returns true on success */
+	/** Modifies the character level, existing ability and passive effect specs are updated in place. Returns true on success */
 	UFUNCTION(BlueprintCallable)
 	virtual bool SetCharacterLevel(int32 NewLevel);
 
@@ -92,6 +132,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Teams")
 	FGenericTeamId GetTeamId() const { return GetGenericTeamId(); }
 
+	/** Called at most once per frame with every health/mana/move speed change since the last call, before the BP events */
+	FOnAttributesChangedNative OnAttributesChangedNative;
+
+	/** Native version of OnDamaged, called for every damage execution before the BP event */
+	FOnCharacterDamagedNative OnDamagedNative;
+
+	/** Returns true if anything consumes per-hit damage info. When false the attribute set skips resolving the damage source */
+	bool WantsDamageNotifies() const;
+
+	/**
+	 * Significance used by the animation budget allocator to decide which meshes update at full rate
+	 * This is the character's score from the significance subsystem, plus 1 when recently rendered
+	 * Player view points come from the controllers so dedicated servers and NullRHI runs are budgeted the same way
+	 */
+	static float CalculateAnimationSignificance(USkeletalMeshComponentBudgeted* Component);
+
 protected:
 	/** The level of this character, should not be modified directly once it has already spawned */
 	UPROPERTY(EditAnywhere, Replicated, Category = Abilities)
@@ -129,9 +185,25 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
 	TMap<FRPGItemSlot, FGameplayAbilitySpecHandle> SlottedAbilities;
 
+	/** Handles of the passive effects applied by AddStartupGameplayAbilities, so their level can be changed without reapplying */
+	TArray<FActiveGameplayEffectHandle> PassiveEffectHandles;
+
 	/** Delegate handles */
 	FDelegateHandle InventoryUpdateHandle;
 	FDelegateHandle InventoryLoadedHandle;
+	FDelegateHandle InventoryBatchHandle;
+
+	/** Attribute changes waiting for the end of frame flush */
+	FRPGAttributeChangeSet PendingAttributeChanges;
+
+	/** True if a flush of PendingAttributeChanges has been scheduled for next tick */
+	uint32 bAttributeFlushPending : 1;
+
+	/** Cached on spawn so we only call into the blueprint VM for events that are actually implemented */
+	uint32 bImplementsOnDamaged : 1;
+	uint32 bImplementsOnHealthChanged : 1;
+	uint32 bImplementsOnManaChanged : 1;
+	uint32 bImplementsOnMoveSpeedChanged : 1;
 
 	/**
 	 * Called when character takes damage, which may have killed them
@@ -148,6 +220,7 @@ protected:
 	/**
 	 * Called when health is changed, either from healing or from being damaged
 	 * For damage this is called in addition to OnDamaged/OnKilled
+	 * All changes made during a frame are merged into one call, unless the change was lethal
 	 *
 	 * @param DeltaValue Change in health value, positive for heal, negative for cost. If 0 the delta is unknown
 	 * @param EventTags The gameplay tags of the event that changed mana
@@ -157,6 +230,7 @@ protected:
 
 	/**
 	 * Called when mana is changed, either from healing or from being used as a cost
+	 * All changes made during a frame are merged into one call
 	 *
 	 * @param DeltaValue Change in mana value, positive for heal, negative for cost. If 0 the delta is unknown
 	 * @param EventTags The gameplay tags of the event that changed mana
@@ -166,6 +240,7 @@ protected:
 
 	/**
 	 * Called when movement speed is changed
+	 * All changes made during a frame are merged into one call
 	 *
 	 * @param DeltaValue Change in move speed
 	 * @param EventTags The gameplay tags of the event that changed mana
@@ -175,6 +250,7 @@ protected:
 
 	/** Called when slotted items change, bound to delegate on interface */
 	void OnItemSlotChanged(FRPGItemSlot ItemSlot, URPGItem* Item);
+	void OnInventoryBatchChanged(const TArray<URPGItem*>& ChangedItems, const TArray<FRPGItemSlot>& ChangedSlots);
 	void RefreshSlottedGameplayAbilities();
 
 	/** Apply the startup gameplay abilities and effects */
@@ -183,6 +259,9 @@ protected:
 	/** Attempts to remove any startup gameplay abilities */
 	void RemoveStartupGameplayAbilities();
 
+	/** Moves startup abilities, slotted abilities and passive effects to the current character level without regranting them */
+	void UpdateStartupAbilityLevels();
+
 	/** Adds slotted item abilities if needed */
 	void AddSlottedGameplayAbilities();
 
@@ -192,6 +271,18 @@ protected:
 	/** Remove slotted gameplay abilities, if force is false it only removes invalid ones */
 	void RemoveSlottedGameplayAbilities(bool bRemoveAll);
 
+	/** Registers the mesh with the animation budget allocator, player controlled characters always animate at full rate */
+	void UpdateAnimationBudgetRegistration();
+
+	/** Scales movement and AI tick rates to the significance tier, and simplifies movement for distant AI. Player controlled characters always run at full rate */
+	virtual void ApplySignificanceTier(ERPGSignificanceTier Tier);
+
+	/** Merges the event tags into PendingAttributeChanges and schedules a flush for next tick if needed */
+	void QueueAttributeFlush(const struct FGameplayTagContainer& EventTags);
+
+	/** Broadcasts and clears PendingAttributeChanges */
+	void FlushAttributeChanges();
+
 	// Called from RPGAttributeSet, these call BP events above
 	virtual void HandleDamage(float DamageAmount, const FHitResult& HitInfo, const struct FGameplayTagContainer& DamageTags, ARPGCharacterBase* InstigatorCharacter, AActor* DamageCauser);
 	virtual void HandleHealthChanged(float DeltaValue, const struct FGameplayTagContainer& EventTags);
@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "RPGCharacterMovementComponent.generated.h"
+
+/**
+ * Character movement with a cheap mode for AI far from every player
+ * Simplified movement walks on the navmesh instead of sweeping the capsule and finding the floor, and only simulates every
+ * SimplifiedMoveInterval. Off dedicated servers the mesh is eased between steps so the lower rate does not show
+ * Walk speed comes from MaxWalkSpeed in both modes, so move speed attribute changes apply the same way
+ */
+UCLASS()
+class ACTIONRPG_API URPGCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGCharacterMovementComponent();
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * Switches between full and simplified movement, and sets how often movement simulates
+	 * Only the server simplifies movement, clients just use the tick interval
+	 */
+	void SetSimplifiedMovement(bool bSimplified, float MoveInterval);
+
+	/** Returns true if the character is using the simplified mover */
+	bool IsSimplifiedMovement() const { return bSimplifiedMovement; }
+
+protected:
+	/** Puts the mesh back on the capsule */
+	void ResetSimplifiedMeshOffset();
+
+	/** Mesh offsets larger than this are snapped instead of eased, as the character was teleported */
+	UPROPERTY(EditDefaultsOnly, Category = "Character Movement: NavMesh Movement")
+	float MaxSimplifiedMeshOffset;
+
+	/** Seconds between navmesh projections while simplified, projecting is the most expensive part of nav walking */
+	UPROPERTY(EditDefaultsOnly, Category = "Character Movement: NavMesh Movement")
+	float SimplifiedNavMeshProjectionInterval;
+
+	/** Land movement mode and projection interval to restore when returning to full movement */
+	TEnumAsByte<EMovementMode> FullLandMovementMode;
+	float FullNavMeshProjectionInterval;
+
+	/** Seconds between simulation steps while simplified */
+	float SimplifiedMoveInterval;
+
+	/** Time since the last simulation step, only used while easing the mesh */
+	float SimplifiedMoveTime;
+
+	/** World space offset of the mesh from the capsule right after the last step, eased to zero by the next one */
+	FVector SimplifiedMeshOffset;
+
+	/** True while using the simplified mover */
+	uint32 bSimplifiedMovement : 1;
+
+	/** True if the component ticks every frame to ease the mesh, and simulates itself every SimplifiedMoveInterval */
+	uint32 bEaseSimplifiedMesh : 1;
+};
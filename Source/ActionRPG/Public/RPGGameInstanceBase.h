@@ -4,6 +4,9 @@
 
 #include "ActionRPG.h"
 #include "Engine/GameInstance.h"
+#include "RPGSaveJournal.h"
+#include "RPGSaveService.h"
+#include "RPGSaveGameReader.h"
 #include "RPGGameInstanceBase.generated.h"
 
 class URPGItem;
@@ -20,8 +23,10 @@ class ACTIONRPG_API URPGGameInstanceBase : public UGameInstance
 	GENERATED_BODY()
 
 public:
-	// Constructor
+	// Constructor and overrides
 	URPGGameInstanceBase();
+	virtual void Init() override;
+	virtual void Shutdown() override;
 
 	/** List of inventory items to add to new players */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory)
@@ -31,7 +36,7 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory)
 	TMap<FPrimaryAssetType, int32> ItemSlotsPerType;
 
-	/** The slot name used for saving */
+	/** The slot name used for saving. There is one save per game instance, it belongs to the local player and remote players are not saved */
 	UPROPERTY(BlueprintReadWrite, Category = Save)
 	FString SaveSlot;
 
@@ -66,7 +71,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Save)
 	void SetSavingEnabled(bool bEnabled);
 
-	/** Synchronously loads a save game. If it fails, it will create a new one for you. Returns true if it loaded, false if it created one */
+	/**
+	 * Synchronously loads a save game. If it fails, it will create a new one for you. Returns true if it loaded, false if it created one
+	 * With bUseMappedSaveReader the inventory items are decoded in the background, OnSaveGameLoaded is called again once they are in
+	 */
 	UFUNCTION(BlueprintCallable, Category = Save)
 	bool LoadOrCreateSaveGame();
 
@@ -74,6 +82,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Save)
 	bool HandleSaveGameLoaded(USaveGame* SaveGameObject);
 
+	/** Returns true while the inventory items of the current save game are still being decoded, it can't be written until they are */
+	UFUNCTION(BlueprintPure, Category = Save)
+	bool IsSaveGameInventoryPending() const { return PendingSaveReader.IsValid(); }
+
 	/** Gets the save game slot and user index used for inventory saving, ready to pass to GameplayStatics save functions */
 	UFUNCTION(BlueprintCallable, Category = Save)
 	void GetSaveSlotInfo(FString& SlotName, int32& UserIndex) const;
@@ -82,6 +94,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Save)
 	bool WriteSaveGame();
 
+	/**
+	 * Writes changes recorded with RecordInventoryItemChange/RecordSlottedItemChange by appending them to the save journal
+	 * Falls back to a full WriteSaveGame if there is no snapshot on disk yet or the journal is due for compaction
+	 */
+	UFUNCTION(BlueprintCallable, Category = Save)
+	bool WriteSaveGameDelta();
+
+	/** Records an inventory change already applied to the current save game, so WriteSaveGameDelta can write only that change */
+	void RecordInventoryItemChange(const FPrimaryAssetId& ItemId, const FRPGItemData& ItemData);
+
+	/** Records a slot change already applied to the current save game */
+	void RecordSlottedItemChange(const FRPGItemSlot& ItemSlot, const FPrimaryAssetId& ItemId);
+
+	/** Returns the service that writes save games on a background thread, use it directly to save other players or slots. Null if disabled */
+	FRPGSaveService* GetSaveService() const { return SaveService.Get(); }
+
 	/** Resets the current save game to it's default. This will erase player data! This won't save to disk until the next WriteSaveGame */
 	UFUNCTION(BlueprintCallable, Category = Save)
 	void ResetSaveGame();
@@ -103,6 +131,41 @@ protected:
 	UPROPERTY()
 	bool bPendingSaveRequested;
 
+	/** If true, inventory changes are appended to a journal next to the save slot instead of rewriting the whole save */
+	UPROPERTY(EditDefaultsOnly, Category = Save)
+	bool bUseSaveJournal;
+
+	/** Number of journal records after which the next delta write does a full save instead, which also empties the journal */
+	UPROPERTY(EditDefaultsOnly, Category = Save, meta = (ClampMin = "1"))
+	int32 SaveJournalCompactionThreshold;
+
+	/** If true, save games are written on the save service's I/O thread, otherwise on the game thread. Both use the same crash safe files */
+	UPROPERTY(EditDefaultsOnly, Category = Save)
+	bool bUseSaveService;
+
+	/** If true, LoadOrCreateSaveGame memory maps the save and only decodes the slotted items before returning */
+	UPROPERTY(EditDefaultsOnly, Category = Save)
+	bool bUseMappedSaveReader;
+
+	/** Reader still decoding the items of PendingItemsSaveGame */
+	TSharedPtr<FRPGSaveGameReader, ESPMode::ThreadSafe> PendingSaveReader;
+	TWeakObjectPtr<URPGSaveGame> PendingItemsSaveGame;
+
+	/** Called when the reader finished decoding the items of a save game */
+	void HandleSaveGameItemsDecoded(URPGSaveGame* SaveGame, bool bSuccess);
+
+	/** Reads and writes the save files, created in Init */
+	TUniquePtr<FRPGSaveService> SaveService;
+
+	/** True if the current save game has a full snapshot on disk the journal can apply to */
+	bool bSaveSnapshotOnDisk;
+
+	/** Journal of changes since the last full save */
+	FRPGSaveJournal SaveJournal;
+
+	/** Returns the journal file for the current save slot and user */
+	FString GetSaveJournalFilename() const;
+
 	/** Called when the async save happens */
 	virtual void HandleAsyncSave(const FString& SlotName, const int32 UserIndex, bool bSuccess);
 };
\ No newline at end of file
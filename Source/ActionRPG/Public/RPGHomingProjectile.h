@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "GameplayTagContainer.h"
+#include "RPGSignificanceSubsystem.h"
 #include "RPGHomingProjectile.generated.h"
 
 class UProjectileMovementComponent;
@@ -33,6 +34,10 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Turns the trail particles off for projectiles far from every player */
+	void ApplySignificanceTier(ERPGSignificanceTier Tier);
 
 	/** Called when projectile hits something */
 	UFUNCTION()
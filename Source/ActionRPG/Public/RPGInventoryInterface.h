@@ -33,6 +33,9 @@ public:
 	/** Gets the delegate for inventory slot changes */
 	virtual FOnSlottedItemChangedNative& GetSlottedItemChangedDelegate() = 0;
 
+	/** Gets the delegate for batched inventory changes, the native item and slot delegates are not called for changes inside a batch */
+	virtual FOnInventoryBatchChangedNative& GetInventoryBatchChangedDelegate() = 0;
+
 	/** Gets the delegate for when the inventory loads */
 	virtual FOnInventoryLoadedNative& GetInventoryLoadedDelegate() = 0;
 };
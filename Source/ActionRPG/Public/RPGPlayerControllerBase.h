@@ -7,6 +7,36 @@
 #include "RPGInventoryInterface.h"
 #include "RPGPlayerControllerBase.generated.h"
 
+struct FStreamableHandle;
+class URPGInventoryComponent;
+
+/** Kinds of inventory change that can be held back while the saved inventory is loading */
+enum class ERPGDeferredInventoryEditType : uint8
+{
+	AddItem,
+	RemoveItem,
+	SetSlot,
+};
+
+/** Inventory change made while the item assets were still streaming in, applied on top of the loaded inventory */
+USTRUCT()
+struct ACTIONRPG_API FRPGDeferredInventoryEdit
+{
+	GENERATED_BODY()
+
+	ERPGDeferredInventoryEditType EditType = ERPGDeferredInventoryEditType::AddItem;
+
+	/** Item to add, remove or slot, null empties the slot */
+	UPROPERTY()
+	URPGItem* Item = nullptr;
+
+	/** Arguments of the call that was held back */
+	int32 ItemCount = 0;
+	int32 ItemLevel = 0;
+	bool bAutoSlot = false;
+	FRPGItemSlot ItemSlot;
+};
+
 /** Base class for PlayerController, should be blueprinted */
 UCLASS()
 class ACTIONRPG_API ARPGPlayerControllerBase : public APlayerController, public IRPGInventoryInterface
@@ -15,8 +45,13 @@ class ACTIONRPG_API ARPGPlayerControllerBase : public APlayerController, public
 
 public:
 	// Constructor and overrides
-	ARPGPlayerControllerBase() {}
+	ARPGPlayerControllerBase();
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Replicates the inventory to the owning client in networked games, the server is authoritative */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
+	URPGInventoryComponent* InventoryComponent;
 
 	/** Map of all items owned by this player, from definition to data */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
@@ -48,6 +83,17 @@ public:
 	/** Native version above, called before BP delegate */
 	FOnSlottedItemChangedNative OnSlottedItemChangedNative;
 
+	/** Delegate called when an inventory batch ends, the Blueprint item and slot delegates are called once per change before it */
+	UPROPERTY(BlueprintAssignable, Category = Inventory)
+	FOnInventoryBatchChanged OnInventoryBatchChanged;
+
+	/** Native version above, called before BP delegate */
+	FOnInventoryBatchChangedNative OnInventoryBatchChangedNative;
+
+	/** Called after an inventory batch ended and we notified all delegates */
+	UFUNCTION(BlueprintImplementableEvent, Category = Inventory)
+	void InventoryBatchChanged(const TArray<URPGItem*>& ChangedItems, const TArray<FRPGItemSlot>& ChangedSlots);
+
 	/** Delegate called when the inventory has been loaded/reloaded */
 	UPROPERTY(BlueprintAssignable, Category = Inventory)
 	FOnInventoryLoaded OnInventoryLoaded;
@@ -55,6 +101,13 @@ public:
 	/** Native version above, called before BP delegate */
 	FOnInventoryLoadedNative OnInventoryLoadedNative;
 
+	/** Delegate called while the inventory item assets are streaming in, for loading screens */
+	UPROPERTY(BlueprintAssignable, Category = Inventory)
+	FOnInventoryLoadProgress OnInventoryLoadProgress;
+
+	/** Native version above, called before BP delegate */
+	FOnInventoryLoadProgressNative OnInventoryLoadProgressNative;
+
 	/** Adds a new inventory item, will add it to an empty slot if possible. If the item supports count you can add more than one count. It will also update the level when adding if required */
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	bool AddInventoryItem(URPGItem* NewItem, int32 ItemCount = 1, int32 ItemLevel = 1, bool bAutoSlot = true);
@@ -63,6 +116,30 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	bool RemoveInventoryItem(URPGItem* RemovedItem, int32 RemoveCount = 1);
 
+	/** Adds several inventory items in one batch, an item listed twice is added twice. Returns true if anything changed */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool AddInventoryItems(const TArray<URPGItem*>& NewItems, int32 ItemCount = 1, int32 ItemLevel = 1, bool bAutoSlot = true);
+
+	/** Removes several inventory items in one batch. Returns true if anything changed */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool RemoveInventoryItems(const TArray<URPGItem*>& RemovedItems, int32 RemoveCount = 1);
+
+	/**
+	 * Starts batching inventory changes, item and slot notifications are held back until the matching EndInventoryBatch
+	 * Batches can nest, the outermost end sends a single OnInventoryBatchChanged. The Blueprint item and slot delegates and events
+	 * are then called once for each changed item and slot, the native ones are not. Native code should use FRPGInventoryBatch
+	 */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void BeginInventoryBatch();
+
+	/** Ends a batch started with BeginInventoryBatch */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void EndInventoryBatch();
+
+	/** Returns true if inventory changes are currently being batched */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	bool IsInventoryBatchOpen() const { return InventoryBatchDepth > 0; }
+
 	/** Returns all inventory items of a given type. If none is passed as type it will return all */
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	void GetInventoryItems(TArray<URPGItem*>& Items, FPrimaryAssetType ItemType);
@@ -83,6 +160,10 @@ public:
 	UFUNCTION(BlueprintPure, Category = Inventory)
 	URPGItem* GetSlottedItem(FRPGItemSlot ItemSlot) const;
 
+	/** Asks the server to change a slot, clients call this instead of SetSlottedItem */
+	UFUNCTION(Server, Reliable, BlueprintCallable, Category = Inventory)
+	void ServerSetSlottedItem(FRPGItemSlot ItemSlot, URPGItem* Item);
+
 	/** Returns all slotted items of a given type. If none is passed as type it will return all */
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	void GetSlottedItems(TArray<URPGItem*>& Items, FPrimaryAssetType ItemType, bool bOutputEmptyIndexes);
@@ -91,14 +172,44 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	void FillEmptySlots();
 
-	/** Manually save the inventory, this is called from add/remove functions automatically */
+	/** Manually save the inventory right away. Add/remove functions call RequestSaveInventory instead, which batches saves */
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	bool SaveInventory();
 
-	/** Loads inventory from save game on game instance, this will replace arrays */
+	/** Marks the inventory as needing a save, the save happens at most once per InventorySaveInterval */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void RequestSaveInventory();
+
+	/** Saves now if a save was requested and has not happened yet, call this at checkpoints. Returns true if it saved */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool FlushInventorySave();
+
+	/** Returns the number of save requests that were merged into another save instead of writing on their own */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	int32 GetAvoidedInventorySaveCount() const { return AvoidedInventorySaveCount; }
+
+	/** Seconds to wait after an inventory change before saving, so bursts of changes only write once. 0 saves on every change */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Inventory)
+	float InventorySaveInterval;
+
+	/**
+	 * Loads inventory from save game on game instance, this will replace arrays
+	 * The game instance holds a single save for the local player, so on a server only the local controller loads and saves it
+	 * Item assets are streamed in asynchronously, OnInventoryLoaded is called once they are all ready
+	 * Changes made in the meantime are held back and applied on top of the loaded inventory, and a save requested then happens after it
+	 * Returns true if there was a save game to load from
+	 */
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	bool LoadInventory();
 
+	/** Returns true if the inventory has finished loading item assets */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	bool IsInventoryLoaded() const { return !bInventoryLoadPending; }
+
+	/** Called by the inventory component on clients when replicated items or slots change. Invalid data removes the item */
+	void ApplyReplicatedItem(URPGItem* Item, const FRPGItemData& ItemData);
+	void ApplyReplicatedSlot(const FRPGItemSlot& ItemSlot, URPGItem* Item);
+
 	// Implement IRPGInventoryInterface
 	virtual const TMap<URPGItem*, FRPGItemData>& GetInventoryDataMap() const override
 	{
@@ -116,6 +227,10 @@ public:
 	{
 		return OnSlottedItemChangedNative;
 	}
+	virtual FOnInventoryBatchChangedNative& GetInventoryBatchChangedDelegate() override
+	{
+		return OnInventoryBatchChangedNative;
+	}
 	virtual FOnInventoryLoadedNative& GetInventoryLoadedDelegate() override
 	{
 		return OnInventoryLoadedNative;
@@ -125,11 +240,104 @@ protected:
 	/** Auto slots a specific item, returns true if anything changed */
 	bool FillEmptySlotWithItem(URPGItem* NewItem);
 
+	/** Returns true if storage changes should be mirrored into the inventory component for clients */
+	bool ShouldReplicateInventory() const;
+
+	/** Returns true if inventory changes and saves have to wait for a load to finish */
+	bool IsInventoryChangeDeferred() const { return bInventoryLoadPending || bSaveGameItemsPending; }
+
+	/** Sends only the differences between the reloaded inventory and what clients already have, called when a load finishes */
+	void FinishReplicatedInventorySync();
+
+	/** Storage updates that keep the maps and replicated inventory in sync, these do not notify */
+	void SetInventoryItemData(URPGItem* Item, const FRPGItemData& ItemData);
+	void RemoveInventoryItemData(URPGItem* Item);
+	void SetSlotContents(const FRPGItemSlot& ItemSlot, URPGItem* Item);
+
 	/** Calls the inventory update callbacks */
 	void NotifyInventoryItemChanged(bool bAdded, URPGItem* Item);
 	void NotifySlottedItemChanged(FRPGItemSlot ItemSlot, URPGItem* Item);
+	void NotifyInventoryBatchChanged();
 	void NotifyInventoryLoaded();
+	void NotifyInventoryLoadProgress(float Progress);
+
+	/** Called when the item assets requested by LoadInventory are in memory */
+	void HandleInventoryAssetsLoaded();
+
+	/** Replays the changes made while the inventory was loading */
+	void ApplyDeferredInventoryEdits();
+
+	/** Called as the item assets requested by LoadInventory stream in */
+	void HandleInventoryLoadUpdate(TSharedRef<FStreamableHandle> Handle);
 
 	/** Called when a global save game as been loaded */
 	void HandleSaveGameLoaded(URPGSaveGame* NewSaveGame);
+
+	/** Called by the save timer once the save interval has passed */
+	void HandleInventorySaveTimer();
+
+	/** True if the inventory changed since the last save */
+	uint32 bInventorySaveDirty : 1;
+
+	/** True if the save game matches the inventory apart from the pending changes below, otherwise the next save rebuilds it */
+	uint32 bSaveGameInSync : 1;
+
+	/** True while LoadInventory is waiting for item assets */
+	uint32 bInventoryLoadPending : 1;
+
+	/** True while the slots of the save are loaded but the game instance is still decoding its items, changes are held back like during a load */
+	uint32 bSaveGameItemsPending : 1;
+
+	/** True while LoadInventory rebuilds the inventory, the replicated inventory is brought in line with the result once it is done */
+	uint32 bReplicatedInventorySyncPending : 1;
+
+	/** Changes made while LoadInventory was waiting for item assets, in the order they were made */
+	UPROPERTY()
+	TArray<FRPGDeferredInventoryEdit> DeferredInventoryEdits;
+
+	/** Keeps the inventory item assets loaded, and lets a newer load cancel an older one */
+	TSharedPtr<FStreamableHandle> InventoryLoadHandle;
+
+	/** Item and slot changes since the last save, keyed by id so they can be applied to the save game without a full rebuild */
+	TMap<FPrimaryAssetId, FRPGItemData> PendingItemChanges;
+	TMap<FRPGItemSlot, FPrimaryAssetId> PendingSlotChanges;
+
+	/** Number of open inventory batches */
+	int32 InventoryBatchDepth;
+
+	/** Items and slots changed during the open batch, each listed once. BatchedItemAdded is the last bAdded of each item */
+	UPROPERTY()
+	TArray<URPGItem*> BatchedItemChanges;
+	TArray<bool> BatchedItemAdded;
+	TArray<FRPGItemSlot> BatchedSlotChanges;
+
+	/** Number of save requests merged into a pending save */
+	int32 AvoidedInventorySaveCount;
+
+	/** Timer for the pending inventory save */
+	FTimerHandle InventorySaveTimerHandle;
+};
+
+/** Batches inventory changes on a controller for the lifetime of the scope, see ARPGPlayerControllerBase::BeginInventoryBatch */
+struct FRPGInventoryBatch : public FNoncopyable
+{
+	explicit FRPGInventoryBatch(ARPGPlayerControllerBase* InController)
+		: Controller(InController)
+	{
+		if (Controller)
+		{
+			Controller->BeginInventoryBatch();
+		}
+	}
+
+	~FRPGInventoryBatch()
+	{
+		if (Controller)
+		{
+			Controller->EndInventoryBatch();
+		}
+	}
+
+private:
+	ARPGPlayerControllerBase* Controller;
 };
@@ -18,6 +18,10 @@ namespace ERPGSaveGameVersion
 		AddedInventory,
 		// Added ItemData to store count/level
 		AddedItemData,
+		// Inventory and slots moved out of tagged properties into a compact block with a string table and packed ints
+		CompactInventory,
+		// Slots and items in separate blocks with a footer pointing at them, so the slots can be read without the items
+		SectionedInventory,
 
 		// -----<new versions must be added before this line>-------------------------------------------------
 		VersionPlusOne,
@@ -35,8 +39,9 @@ public:
 	/** Constructor */
 	URPGSaveGame()
 	{
-		// Set to current version, this will get overwritten during serialization when loading
-		SavedDataVersion = ERPGSaveGameVersion::LatestVersion;
+		// Tagged properties are only written when they differ from the class default, so the default has to be a version that
+		// can't be mistaken for a newer one. Serialize sets LatestVersion when saving, which makes sure it is always written
+		SavedDataVersion = ERPGSaveGameVersion::Initial;
 	}
 
 	/** Map of items to item data */
@@ -51,6 +56,16 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = SaveGame)
 	FString UserId;
 
+	/** Increased on every full write, the save journal is only replayed on top of the snapshot with a matching generation */
+	UPROPERTY()
+	int32 JournalGeneration = 0;
+
+	/** Decodes the slot section written from SectionedInventory on, safe to call from any thread. Returns false if it is corrupt */
+	static bool ReadSlottedItemsSection(FArchive& Ar, TMap<FRPGItemSlot, FPrimaryAssetId>& OutSlottedItems);
+
+	/** Decodes the item section written from SectionedInventory on, safe to call from any thread. Returns false if it is corrupt */
+	static bool ReadInventoryItemsSection(FArchive& Ar, TMap<FPrimaryAssetId, FRPGItemData>& OutInventoryData);
+
 protected:
 	/** Deprecated way of storing items, this is read in but not saved out */
 	UPROPERTY()
@@ -62,4 +77,7 @@ protected:
 
 	/** Overridden to allow version fixups */
 	virtual void Serialize(FArchive& Ar) override;
+
+	/** Reads or writes InventoryData and SlottedItems as a compact block, used from CompactInventory on */
+	void SerializeCompactInventory(FArchive& Ar);
 };
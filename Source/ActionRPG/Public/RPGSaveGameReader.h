@@ -0,0 +1,49 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+
+class URPGSaveGame;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Reads save games straight from a memory mapped file, for saves written from ERPGSaveGameVersion::SectionedInventory on
+ * Only the tagged part in front of the inventory is copied and deserialized up front, and the slot section is decoded right
+ * away so the player can spawn with their equipment. The item section stays in the mapping until DecodeInventoryItemsAsync
+ * decodes it on a worker thread, so the time until the save game is usable does not depend on the inventory size
+ */
+class ACTIONRPG_API FRPGSaveGameReader : public TSharedFromThis<FRPGSaveGameReader, ESPMode::ThreadSafe>
+{
+public:
+	FRPGSaveGameReader();
+	~FRPGSaveGameReader();
+
+	/** Maps a save file and finds its sections. Returns false if the file does not exist or was written by an older version */
+	bool Open(const FString& Filename);
+
+	/** Creates the save game with everything but the inventory items, which are left for DecodeInventoryItemsAsync. Game thread only */
+	URPGSaveGame* LoadSaveGame();
+
+	/** Decodes the item section on a worker thread, then adds the items to the save game and calls OnComplete on the game thread */
+	void DecodeInventoryItemsAsync(URPGSaveGame* SaveGame, TFunction<void(bool)> OnComplete);
+
+	/** Unmaps the file */
+	void Close();
+
+	/** Returns true while the file is mapped */
+	bool IsOpen() const { return MappedRegion.IsValid(); }
+
+private:
+	/** Returns a view of the mapped file from Offset to End */
+	TArrayView<const uint8> GetView(int64 Offset, int64 End) const;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** File offsets of the sections, the items end where the footer starts */
+	int64 SlotsOffset;
+	int64 ItemsOffset;
+	int64 FooterOffset;
+};
@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+
+class URPGSaveGame;
+
+/**
+ * Append-only journal of inventory changes made since the last full save game write
+ * The full save game is the base snapshot, and the journal only applies to the snapshot with the same generation
+ * Records are fixed size apart from string definitions, so a write costs the size of the change and not of the inventory
+ * A torn write at the end of the file is detected on replay and cut off, every complete record before it is kept
+ */
+class ACTIONRPG_API FRPGSaveJournal
+{
+public:
+	FRPGSaveJournal();
+
+	/**
+	 * Reads the journal file and applies it to a save game that was just loaded
+	 * If the journal belongs to a different generation it is started over
+	 * Returns the number of records that were replayed
+	 */
+	int32 Replay(const FString& InFilename, URPGSaveGame* SaveGame);
+
+	/**
+	 * Starts an empty journal on disk for the passed in snapshot generation, this is called after every full save
+	 * Queued records are kept, they were made after the snapshot was taken and go to the new journal with the next Flush
+	 */
+	bool Reset(const FString& InFilename, int32 InGeneration);
+
+	/** Forgets the journal without touching disk, used when the save game is replaced in memory */
+	void Discard();
+
+	/** Forgets the journal and deletes its file, used when the save game is reset so stale records can't be replayed */
+	void Delete(const FString& InFilename);
+
+	/** Queues a change of item data, data that is not valid means the item was removed */
+	void RecordItem(const FPrimaryAssetId& ItemId, const FRPGItemData& ItemData);
+
+	/** Queues a change to a slot, an invalid item id means the slot was emptied */
+	void RecordSlot(const FRPGItemSlot& ItemSlot, const FPrimaryAssetId& ItemId);
+
+	/** Appends all queued records to the journal file. Returns false if the journal is not open or the write failed */
+	bool Flush();
+
+	/** Drops queued records, used when they are already part of a full save */
+	void ClearPendingRecords();
+
+	/** Returns true if Replay or Reset opened a journal file that can be appended to */
+	bool IsOpen() const { return !Filename.IsEmpty(); }
+
+	/** Returns true if there are records that have not been written */
+	bool HasPendingRecords() const { return PendingItems.Num() > 0 || PendingSlots.Num() > 0; }
+
+	/** Returns the number of records in the journal file plus queued records */
+	int32 GetRecordCount() const { return WrittenRecordCount + PendingItems.Num() + PendingSlots.Num(); }
+
+private:
+	/** Returns the string table index for a name, adding a definition record to Ar if it is new */
+	int32 GetStringIndex(FName Name, FArchive& Ar);
+
+	/** Forgets the file and its string table, queued records are kept */
+	void Close();
+
+	/** Closes the file after a failed append, queued records are kept */
+	void CloseAfterFailedWrite();
+
+	/** Queued changes, keyed so repeated changes to the same entry only write the last one */
+	TMap<FPrimaryAssetId, FRPGItemData> PendingItems;
+	TMap<FRPGItemSlot, FPrimaryAssetId> PendingSlots;
+
+	/** String table for names written so far, shared by item types, item names and slot types */
+	TMap<FName, int32> StringIndices;
+	TArray<FName> Strings;
+
+	/** File being appended to, empty when closed */
+	FString Filename;
+
+	/** Generation of the snapshot this journal applies to */
+	int32 Generation;
+
+	/** Number of item and slot records in the file */
+	int32 WrittenRecordCount;
+};
@@ -0,0 +1,100 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Async/Future.h"
+#include "HAL/Runnable.h"
+
+class USaveGame;
+class FRunnableThread;
+class FEvent;
+
+/**
+ * Writes and reads save games for any number of slots and users without blocking the game thread
+ * Save objects are serialized to memory on the game thread, where they are safe to read, and everything touching disk happens
+ * on one dedicated I/O thread. A write goes to a temporary file, then the old save is renamed to a backup and the temporary
+ * file takes its place, so a complete save is on disk at every point even if the game crashes. A save queued for a slot that
+ * already has a queued save replaces its data instead of adding another write, so the work per slot is bounded no matter how often it is saved
+ * Requests for the same slot complete in the order they were made, and all futures are fulfilled on the game thread
+ * Without a running I/O thread requests are done right away on the calling thread
+ */
+class ACTIONRPG_API FRPGSaveService : public FRunnable
+{
+public:
+	FRPGSaveService();
+	virtual ~FRPGSaveService();
+
+	/** Starts the I/O thread, returns false if it could not be created */
+	bool Start();
+
+	/** Finishes every queued request and stops the I/O thread */
+	void Shutdown();
+
+	/** Queues a save game to be written to a slot, the future is true if it made it to disk */
+	TFuture<bool> SaveGameAsync(USaveGame* SaveGame, const FString& SlotName, int32 UserIndex);
+
+	/** Queues a load of a slot, the future is null if there was no valid save. The caller must reference the result to keep it alive */
+	TFuture<USaveGame*> LoadGameAsync(const FString& SlotName, int32 UserIndex);
+
+	/** Returns the number of requests waiting for the I/O thread */
+	int32 GetNumQueuedRequests() const;
+
+	/** Returns the number of saves that were merged into an already queued save of the same slot */
+	int32 GetNumMergedSaves() const { return NumMergedSaves; }
+
+	/** Returns the file a slot of a user is written to */
+	static FString GetSaveFilename(const FString& SlotName, int32 UserIndex);
+
+	/** Returns the file a load of the slot has to read. If the save itself is missing this is the backup, or the temporary file if there is no backup. Empty if there is no save */
+	static FString FindSaveFileToLoad(const FString& SlotName, int32 UserIndex);
+
+	/** Loads a slot on the game thread right away, recovering from interrupted writes the same way LoadGameAsync does */
+	static USaveGame* LoadGame(const FString& SlotName, int32 UserIndex);
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	/** One queued load or save */
+	struct FRequest
+	{
+		FString Filename;
+
+		/** Slot and user to load */
+		FString SlotName;
+		int32 UserIndex = 0;
+
+		/** Serialized save game to write, empty for loads */
+		TArray<uint8> Data;
+
+		/** Everyone waiting on this save, more than one if saves were merged */
+		TArray<TSharedRef<TPromise<bool>>> SavePromises;
+
+		/** Set for loads */
+		TSharedPtr<TPromise<USaveGame*>> LoadPromise;
+	};
+
+	/** Runs a request on the I/O thread and sends the result to the game thread */
+	void ProcessRequest(FRequest& Request);
+
+	/** Replaces a save file with new data, keeping the old one as a backup */
+	static bool WriteSaveFile(const TArray<uint8>& Data, const FString& Filename);
+
+	/** Requests in the order they were made */
+	TArray<FRequest> Queue;
+	mutable FCriticalSection QueueCriticalSection;
+
+	/** Wakes the I/O thread */
+	FEvent* WorkEvent;
+
+	/** The I/O thread, null when not running */
+	FRunnableThread* Thread;
+
+	/** Set when the thread should exit once the queue is empty */
+	TAtomic<bool> bStopping;
+
+	/** Number of saves merged into a queued one */
+	int32 NumMergedSaves;
+};
@@ -0,0 +1,163 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RPGSignificanceSubsystem.generated.h"
+
+/** How much an actor matters to the players, work that can be scaled down reads this instead of measuring on its own */
+UENUM(BlueprintType)
+enum class ERPGSignificanceTier : uint8
+{
+	/** Near a player or in view, full fidelity */
+	High,
+	/** Visible but not close */
+	Medium,
+	/** Far away or out of view */
+	Low,
+	/** Far from every player, only enough work to stay correct */
+	Dormant
+};
+
+/** What each system is allowed to spend on an actor at one significance tier */
+USTRUCT()
+struct ACTIONRPG_API FRPGSignificanceTierSettings
+{
+	GENERATED_BODY()
+
+	/** Lowest significance that still gets this tier */
+	UPROPERTY(Config)
+	float MinSignificance = 0.0f;
+
+	/** Tick interval of AI character movement, 0 ticks every frame */
+	UPROPERTY(Config)
+	float MovementTickInterval = 0.0f;
+
+	/** If true, AI characters walk on the navmesh instead of running the full floor finding simulation */
+	UPROPERTY(Config)
+	bool bSimplifiedMovement = false;
+
+	/** Tick interval of the AI brain, which is how often the StateTree looks for targets */
+	UPROPERTY(Config)
+	float AIThinkInterval = 0.0f;
+
+	/** Tick interval of projectiles that steer themselves */
+	UPROPERTY(Config)
+	float ProjectileTickInterval = 0.0f;
+
+	/** If false, cosmetic particles are not spawned */
+	UPROPERTY(Config)
+	bool bSpawnEffects = true;
+};
+
+/** Called when a registered actor moves to a different tier, and once on registration */
+DECLARE_DELEGATE_OneParam(FOnSignificanceTierChanged, ERPGSignificanceTier);
+
+/**
+ * Scores registered characters and projectiles by distance and view relevance to every player and buckets them into tiers
+ * Scores go from 0 at MaxDistance from the nearest player to 1 next to one, and are scaled down out of the player's view
+ * Player controlled pawns are always High. Tier settings can be changed in [/Script/ActionRPG.RPGSignificanceSubsystem]
+ */
+UCLASS(Config = Game)
+class ACTIONRPG_API URPGSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGSignificanceSubsystem();
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Returns the subsystem of an object's world, null outside game worlds */
+	static URPGSignificanceSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Returns the tier of an actor, High if it is not registered or there is no subsystem */
+	static ERPGSignificanceTier GetActorTier(const AActor* Actor);
+
+	/** Returns the settings for the tier of an actor */
+	static const FRPGSignificanceTierSettings& GetActorTierSettings(const AActor* Actor);
+
+	/** Starts scoring an actor, OnTierChanged is called right away with its first tier */
+	void RegisterActor(AActor* Actor, FOnSignificanceTierChanged&& OnTierChanged);
+
+	/** Stops scoring an actor, call from EndPlay */
+	void UnregisterActor(AActor* Actor);
+
+	/** Returns the last score of an actor from 0 to 1, 1 if it is not registered */
+	float GetSignificance(const AActor* Actor) const;
+
+	/** Returns the last tier of an actor, High if it is not registered */
+	ERPGSignificanceTier GetTier(const AActor* Actor) const;
+
+	/** Returns the settings for a tier */
+	const FRPGSignificanceTierSettings& GetTierSettings(ERPGSignificanceTier Tier) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Point a player sees the world from */
+	struct FViewer
+	{
+		FVector Location;
+		FVector Direction;
+	};
+
+	struct FEntry
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FOnSignificanceTierChanged OnTierChanged;
+		float Significance = 1.0f;
+		ERPGSignificanceTier Tier = ERPGSignificanceTier::High;
+	};
+
+	/** Fills in where every player is looking from */
+	void GatherViewers(TArray<FViewer, TInlineAllocator<4>>& OutViewers) const;
+
+	/** Scores one actor against the viewers */
+	float CalculateSignificance(const AActor* Actor, const TArray<FViewer, TInlineAllocator<4>>& Viewers) const;
+
+	/** Returns the tier for a score, only dropping a tier once the score is Hysteresis below it so actors on a boundary don't flicker */
+	ERPGSignificanceTier GetTierForSignificance(float Significance, ERPGSignificanceTier CurrentTier) const;
+
+	/** Rescores every registered actor and notifies tier changes */
+	void UpdateSignificance();
+
+	/** Registered actors, removed by swapping with the last */
+	TArray<FEntry> Entries;
+
+	/** Index into Entries for each registered actor */
+	TMap<TObjectKey<AActor>, int32> EntryIndices;
+
+	/** Settings for each tier, indexed by ERPGSignificanceTier and ordered from High to Dormant */
+	UPROPERTY(Config)
+	TArray<FRPGSignificanceTierSettings> TierSettings;
+
+	/** Seconds between rescoring everything */
+	UPROPERTY(Config)
+	float UpdateInterval;
+
+	/** Distance from the nearest player at which significance reaches 0 */
+	UPROPERTY(Config)
+	float MaxDistance;
+
+	/** Within this distance actors count as in view, players can turn around faster than the update interval */
+	UPROPERTY(Config)
+	float AlwaysInViewDistance;
+
+	/** Half angle of the view cone in degrees */
+	UPROPERTY(Config)
+	float ViewHalfAngle;
+
+	/** Multiplier on the score of actors outside every player's view cone */
+	UPROPERTY(Config)
+	float OutOfViewScale;
+
+	/** How far below a tier's MinSignificance a score must drop before the actor moves down */
+	UPROPERTY(Config)
+	float Hysteresis;
+
+	/** Time since the last rescore */
+	float TimeSinceUpdate;
+};
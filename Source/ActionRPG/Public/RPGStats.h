@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// ----------------------------------------------------------------------------------------------------------------
+// Stats and trace instrumentation for the game module
+// Use "stat ActionRPG" in game to see the counters, or enable the RPG channel in Unreal Insights (-trace=cpu,rpg)
+// Trace events are only written while RPGChannel is enabled, so the payload helpers are free when it is off
+// ----------------------------------------------------------------------------------------------------------------
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_STATS_GROUP(TEXT("ActionRPG"), STATGROUP_ActionRPG, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Nearest Target"), STAT_RPG_FindNearestTarget, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile Hit"), STAT_RPG_ProjectileHit, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Post Gameplay Effect Execute"), STAT_RPG_PostGameplayEffectExecute, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Inventory"), STAT_RPG_SaveInventory, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Inventory"), STAT_RPG_LoadInventory, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Refresh Slotted Abilities"), STAT_RPG_RefreshSlottedAbilities, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Significance Update"), STAT_RPG_SignificanceUpdate, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batched Tick"), STAT_RPG_BatchedTick, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batched Tick Gather and Apply"), STAT_RPG_BatchedTickDispatch, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Missile Homing Batch"), STAT_RPG_MissileHomingBatch, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Perception Batch"), STAT_RPG_PerceptionBatch, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Patrol Batch"), STAT_RPG_PatrolBatch, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AI Decision Batch"), STAT_RPG_AIDecisionBatch, STATGROUP_ActionRPG, ACTIONRPG_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Target Searches"), STAT_RPG_TargetSearches, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Target Search Candidates"), STAT_RPG_TargetSearchCandidates, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Projectiles"), STAT_RPG_LiveProjectiles, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Avoided Inventory Saves"), STAT_RPG_AvoidedSaves, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Animation Significance Updates"), STAT_RPG_AnimationSignificanceUpdates, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hand Socket Cache Refreshes"), STAT_RPG_HandSocketRefreshes, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Significance Actors"), STAT_RPG_SignificanceActors, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Significance Tier Changes"), STAT_RPG_SignificanceTierChanges, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Simplified Movers"), STAT_RPG_SimplifiedMovers, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Batched Tick Items"), STAT_RPG_BatchedTickItems, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Ticking Projectiles"), STAT_RPG_TickingProjectiles, STATGROUP_ActionRPG, ACTIONRPG_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Save Game Size"), STAT_RPG_SaveGameSize, STATGROUP_ActionRPG, ACTIONRPG_API);
+
+UE_TRACE_CHANNEL_EXTERN(RPGChannel, ACTIONRPG_API);
+
+/** Cycle counter when stats are compiled in, plain Insights CPU scope otherwise so Test builds can still be profiled */
+#if STATS
+#define RPG_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define RPG_SCOPE_CYCLE_COUNTER(Stat) TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
+
+/** Counters and trace payloads for hot paths that need more than a timer */
+namespace RPGStats
+{
+	/** Records a nearest target search and how many actors it had to consider */
+	ACTIONRPG_API void RecordTargetSearch(int32 CandidateCount);
+
+	/** Tracks the number of live projectiles, call from BeginPlay and EndPlay */
+	ACTIONRPG_API void RecordProjectileSpawned();
+	ACTIONRPG_API void RecordProjectileDestroyed();
+
+	/** Records the serialized size of a save game */
+	ACTIONRPG_API void RecordSaveGameSize(int64 NumBytes, bool bLoading);
+}
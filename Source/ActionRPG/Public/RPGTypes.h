@@ -144,10 +144,18 @@ DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInventoryItemChangedNative, bool, URPGIt
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSlottedItemChanged, FRPGItemSlot, ItemSlot, URPGItem*, Item);
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnSlottedItemChangedNative, FRPGItemSlot, URPGItem*);
 
+/** Delegate called once when an inventory batch ends, with every item and slot that changed during it */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnInventoryBatchChanged, const TArray<URPGItem*>&, ChangedItems, const TArray<FRPGItemSlot>&, ChangedSlots);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInventoryBatchChangedNative, const TArray<URPGItem*>&, const TArray<FRPGItemSlot>&);
+
 /** Delegate called when the entire inventory has been loaded, all items may have been replaced */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnInventoryLoaded);
 DECLARE_MULTICAST_DELEGATE(FOnInventoryLoadedNative);
 
+/** Delegate called while inventory item assets stream in, progress goes from 0 to 1 */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInventoryLoadProgress, float, Progress);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnInventoryLoadProgressNative, float);
+
 /** Delegate called when the save game has been loaded/reset */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSaveGameLoaded, URPGSaveGame*, SaveGame);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnSaveGameLoadedNative, URPGSaveGame*);
@@ -4,12 +4,14 @@
 #include "SlateBasics.h"
 #include "SlateExtras.h"
 #include "MoviePlayer.h"
+#include "Containers/Ticker.h"
 #include "Widgets/Images/SThrobber.h"
+#include "Widgets/Notifications/SProgressBar.h"
 
-
+DEFINE_LOG_CATEGORY_STATIC(LogRPGLoadingScreen, Log, All);
 
 // This module must be loaded "PreLoadingScreen" in the .uproject file, otherwise it will not hook in time!
-struct FRPGLoadingScreenBrush : public FSlateDynamicImageBrush//, public FGCObject
+struct FRPGLoadingScreenBrush : public FSlateDynamicImageBrush, public FGCObject
 {
 	FRPGLoadingScreenBrush(const FName InTextureName, const FVector2D& InImageSize)
 		: FSlateDynamicImageBrush(InTextureName, InImageSize)
@@ -17,30 +19,93 @@ struct FRPGLoadingScreenBrush : public FSlateDynamicImageBrush//, public FGCObje
 		SetResourceObject(LoadObject<UObject>(NULL, *InTextureName.ToString()));
 	}
 
-	virtual void AddReferencedObjects(FReferenceCollector& Collector)
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
 	{
 		if (TObjectPtr<UObject> CachedResourceObject = GetResourceObject())
 		{
 			Collector.AddReferencedObject(CachedResourceObject);
 		}
 	}
+
+	virtual FString GetReferencerName() const override
+	{
+		return TEXT("FRPGLoadingScreenBrush");
+	}
+};
+
+/** Progress of everything the loading screen waits for, written on the game thread and read on the loading screen thread */
+class FRPGLoadingProgress
+{
+public:
+	void SetTaskProgress(FName TaskName, float Progress)
+	{
+		FScopeLock Lock(&CriticalSection);
+		ActiveTasks.Add(TaskName, FMath::Clamp(Progress, 0.0f, 1.0f));
+	}
+
+	void EndTask(FName TaskName)
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (ActiveTasks.Remove(TaskName) > 0)
+		{
+			NumFinishedTasks++;
+		}
+	}
+
+	/** Forgets finished tasks so the next load starts from zero */
+	void ResetFinishedTasks()
+	{
+		FScopeLock Lock(&CriticalSection);
+		NumFinishedTasks = 0;
+	}
+
+	bool HasActiveTasks() const
+	{
+		FScopeLock Lock(&CriticalSection);
+		return ActiveTasks.Num() > 0;
+	}
+
+	/** Every task counts the same, finished ones count as done */
+	float GetProgress() const
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		const int32 NumTasks = NumFinishedTasks + ActiveTasks.Num();
+		if (NumTasks == 0)
+		{
+			return 0.0f;
+		}
+
+		float Total = (float)NumFinishedTasks;
+		for (const TPair<FName, float>& Task : ActiveTasks)
+		{
+			Total += Task.Value;
+		}
+		return Total / NumTasks;
+	}
+
+private:
+	mutable FCriticalSection CriticalSection;
+	TMap<FName, float> ActiveTasks;
+	int32 NumFinishedTasks = 0;
 };
 
 class SRPGLoadingScreen : public SCompoundWidget
 {
 public:
 	SLATE_BEGIN_ARGS(SRPGLoadingScreen) {}
+		/** Logo brush, shared by every loading screen */
+		SLATE_ARGUMENT(TSharedPtr<FSlateDynamicImageBrush>, LogoBrush)
+		/** Progress to show */
+		SLATE_ARGUMENT(TSharedPtr<FRPGLoadingProgress>, Progress)
 	SLATE_END_ARGS()
 
 	void Construct(const FArguments& InArgs)
 	{
-		// Load version of the logo with text baked in, path is hardcoded because this loads very early in startup
-		static const FName LoadingScreenName(TEXT("/Game/UI/T_ActionRPG_TransparentLogo.T_ActionRPG_TransparentLogo"));
+		LoadingScreenBrush = InArgs._LogoBrush;
+		Progress = InArgs._Progress;
 
-		LoadingScreenBrush = MakeShareable(new FRPGLoadingScreenBrush(LoadingScreenName, FVector2D(1024, 256)));
-		
-		FSlateBrush *BGBrush = new FSlateBrush();
-		BGBrush->TintColor = FLinearColor(0.034f, 0.034f, 0.034f, 1.0f);
+		BackgroundBrush.TintColor = FLinearColor(0.034f, 0.034f, 0.034f, 1.0f);
 
 		ChildSlot
 			[
@@ -50,7 +115,7 @@ public:
 			.VAlign(VAlign_Fill)
 			[
 				SNew(SBorder)	
-				.BorderImage(BGBrush)
+				.BorderImage(&BackgroundBrush)
 			]
 			+SOverlay::Slot()
 			.HAlign(HAlign_Center)
@@ -72,6 +137,16 @@ public:
 					SNew(SThrobber)
 					.Visibility(this, &SRPGLoadingScreen::GetLoadIndicatorVisibility)
 				]
+				+SVerticalBox::Slot()
+				.AutoHeight()
+				.VAlign(VAlign_Bottom)
+				.HAlign(HAlign_Fill)
+				.Padding(FMargin(10.0f))
+				[
+					SNew(SProgressBar)
+					.Percent(this, &SRPGLoadingScreen::GetLoadPercent)
+					.Visibility(this, &SRPGLoadingScreen::GetLoadIndicatorVisibility)
+				]
 			]
 		];
 	}
@@ -80,12 +155,24 @@ private:
 	/** Rather to show the ... indicator */
 	EVisibility GetLoadIndicatorVisibility() const
 	{
-		bool Vis =  GetMoviePlayer()->IsLoadingFinished();
-		return GetMoviePlayer()->IsLoadingFinished() ? EVisibility::Collapsed : EVisibility::Visible;
+		const bool bLoading = !GetMoviePlayer()->IsLoadingFinished() || (Progress.IsValid() && Progress->HasActiveTasks());
+		return bLoading ? EVisibility::Visible : EVisibility::Collapsed;
 	}
-	
+
+	/** Progress of the loading tasks, the map load itself has no measurable progress */
+	TOptional<float> GetLoadPercent() const
+	{
+		return Progress.IsValid() ? Progress->GetProgress() : 0.0f;
+	}
+
 	/** Loading screen image brush */
 	TSharedPtr<FSlateDynamicImageBrush> LoadingScreenBrush;
+
+	/** Background of the whole screen */
+	FSlateBrush BackgroundBrush;
+
+	/** Shared with the module */
+	TSharedPtr<FRPGLoadingProgress> Progress;
 };
 
 class FActionRPGLoadingScreenModule : public IActionRPGLoadingScreenModule
@@ -93,14 +180,28 @@ class FActionRPGLoadingScreenModule : public IActionRPGLoadingScreenModule
 public:
 	virtual void StartupModule() override
 	{
-		// Force load for cooker reference
-		LoadObject<UObject>(nullptr, TEXT("/Game/UI/T_ActionRPG_TransparentLogo.T_ActionRPG_TransparentLogo") );
+		// Load version of the logo with text baked in, path is hardcoded because this loads very early in startup
+		// This is the only load of the logo, every loading screen shares the brush. It also keeps the texture referenced for the cooker
+		static const FName LoadingScreenName(TEXT("/Game/UI/T_ActionRPG_TransparentLogo.T_ActionRPG_TransparentLogo"));
+		LogoBrush = MakeShared<FRPGLoadingScreenBrush>(LoadingScreenName, FVector2D(1024, 256));
+
+		Progress = MakeShared<FRPGLoadingProgress>();
+
+		PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddRaw(this, &FActionRPGLoadingScreenModule::HandlePreLoadMap);
+		PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FActionRPGLoadingScreenModule::HandlePostLoadMap);
 
 		if (IsMoviePlayerEnabled())
 		{
 			CreateScreen();
 		}
 	}
+
+	virtual void ShutdownModule() override
+	{
+		FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+		FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+		FTSTicker::GetCoreTicker().RemoveTicker(WaitTickerHandle);
+	}
 	
 	virtual bool IsGameModule() const override
 	{
@@ -109,29 +210,139 @@ public:
 
 	virtual void StartInGameLoadingScreen(bool bPlayUntilStopped, float PlayTime) override
 	{
-		FLoadingScreenAttributes LoadingScreen;
-		LoadingScreen.bAutoCompleteWhenLoadingCompletes = !bPlayUntilStopped;
-		LoadingScreen.bWaitForManualStop = bPlayUntilStopped;
-		LoadingScreen.bAllowEngineTick = bPlayUntilStopped;
+		FLoadingScreenAttributes LoadingScreen = MakeAttributes();
+		if (bPlayUntilStopped)
+		{
+			// Only StopInGameLoadingScreen ends it
+			bManualStopRequested = true;
+		}
+		else
+		{
+			// Played for a time, the movie player takes it down on its own even if no map load follows
+			LoadingScreen.bAutoCompleteWhenLoadingCompletes = true;
+			LoadingScreen.bWaitForManualStop = false;
+		}
 		LoadingScreen.MinimumLoadingScreenDisplayTime = PlayTime;
-		LoadingScreen.WidgetLoadingScreen = SNew(SRPGLoadingScreen);
 		GetMoviePlayer()->SetupLoadingScreen(LoadingScreen);
 	}
 
 	virtual void StopInGameLoadingScreen() override
 	{
-		GetMoviePlayer()->StopMovie();
+		bManualStopRequested = false;
+		FinishLoading();
+	}
+
+	virtual void SetLoadingTaskProgress(FName TaskName, float InProgress) override
+	{
+		Progress->SetTaskProgress(TaskName, InProgress);
+	}
+
+	virtual void EndLoadingTask(FName TaskName) override
+	{
+		Progress->EndTask(TaskName);
 	}
 
 	virtual void CreateScreen()
+	{
+		GetMoviePlayer()->SetupLoadingScreen(MakeAttributes());
+	}
+
+protected:
+	/** Map loads are held on screen until every loading task ended, instead of for a fixed time */
+	FLoadingScreenAttributes MakeAttributes() const
 	{
 		FLoadingScreenAttributes LoadingScreen;
-		LoadingScreen.bAutoCompleteWhenLoadingCompletes = true;
-		LoadingScreen.MinimumLoadingScreenDisplayTime = 3.f;
-		LoadingScreen.WidgetLoadingScreen = SNew(SRPGLoadingScreen);
-		GetMoviePlayer()->SetupLoadingScreen(LoadingScreen);
+		LoadingScreen.bAutoCompleteWhenLoadingCompletes = false;
+		LoadingScreen.bWaitForManualStop = true;
+		LoadingScreen.bAllowEngineTick = true;
+		LoadingScreen.MinimumLoadingScreenDisplayTime = 0.0f;
+		LoadingScreen.WidgetLoadingScreen = SNew(SRPGLoadingScreen).LogoBrush(LogoBrush).Progress(Progress);
+		return LoadingScreen;
+	}
+
+	void HandlePreLoadMap(const FString& MapName)
+	{
+		LoadingMapName = MapName;
+		LoadStartTime = FPlatformTime::Seconds();
+		MapLoadedTime = 0.0;
+
+		if (IsMoviePlayerEnabled() && !GIsEditor && !GetMoviePlayer()->IsMovieCurrentlyPlaying())
+		{
+			CreateScreen();
+		}
+	}
+
+	void HandlePostLoadMap(UWorld* LoadedWorld)
+	{
+		MapLoadedTime = FPlatformTime::Seconds();
+
+		// Check from the next tick, so BeginPlay has had a chance to start its loading tasks
+		if (!WaitTickerHandle.IsValid())
+		{
+			WaitTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FActionRPGLoadingScreenModule::TickWaitForTasks));
+		}
+	}
+
+	bool TickWaitForTasks(float DeltaTime)
+	{
+		if (bManualStopRequested)
+		{
+			return true;
+		}
+
+		if (Progress->HasActiveTasks())
+		{
+			if (FPlatformTime::Seconds() - MapLoadedTime < MaxTaskWaitSeconds)
+			{
+				return true;
+			}
+
+			// Something never ended its task, don't keep the player stuck
+			UE_LOG(LogRPGLoadingScreen, Warning, TEXT("Loading tasks for %s did not end within %.0f s, hiding the loading screen anyway"), *LoadingMapName, MaxTaskWaitSeconds);
+		}
+
+		WaitTickerHandle.Reset();
+		FinishLoading();
+		return false;
 	}
 
+	/** Takes the screen down and logs how long the load took */
+	void FinishLoading()
+	{
+		if (GetMoviePlayer()->IsMovieCurrentlyPlaying())
+		{
+			GetMoviePlayer()->StopMovie();
+		}
+
+		if (LoadStartTime > 0.0)
+		{
+			const double EndTime = FPlatformTime::Seconds();
+			const double MapTime = MapLoadedTime > 0.0 ? MapLoadedTime - LoadStartTime : EndTime - LoadStartTime;
+			UE_LOG(LogRPGLoadingScreen, Log, TEXT("Loaded %s in %.3f s (map %.3f s, loading tasks %.3f s)"), *LoadingMapName, EndTime - LoadStartTime, MapTime, EndTime - LoadStartTime - MapTime);
+			LoadStartTime = 0.0;
+		}
+
+		Progress->ResetFinishedTasks();
+	}
+
+	/** Shared by every loading screen widget */
+	TSharedPtr<FSlateDynamicImageBrush> LogoBrush;
+	TSharedPtr<FRPGLoadingProgress> Progress;
+
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+	FTSTicker::FDelegateHandle WaitTickerHandle;
+
+	/** Map being loaded and when, for the load time log */
+	FString LoadingMapName;
+	double LoadStartTime = 0.0;
+	double MapLoadedTime = 0.0;
+
+	/** Longest the screen waits for loading tasks after the map loaded */
+	static constexpr double MaxTaskWaitSeconds = 30.0;
+
+	/** Set while an in game loading screen was asked to play until stopped */
+	bool bManualStopRequested = false;
 };
 
 IMPLEMENT_GAME_MODULE(FActionRPGLoadingScreenModule, ActionRPGLoadingScreen);
@@ -15,9 +15,24 @@ public:
 		return FModuleManager::LoadModuleChecked<IActionRPGLoadingScreenModule>("ActionRPGLoadingScreen");
 	}
 
-	/** Kicks off the loading screen for in game loading (not startup) */
+	/** Returns true if the module is loaded, it is client only so servers never have it */
+	static inline bool IsAvailable()
+	{
+		return FModuleManager::Get().IsModuleLoaded("ActionRPGLoadingScreen");
+	}
+
+	/** Kicks off the loading screen for in game loading (not startup). Unless played until stopped, it stays up until all loading tasks end */
 	virtual void StartInGameLoadingScreen(bool bPlayUntilStopped, float PlayTime) = 0;
 
 	/** Stops the loading screen */
 	virtual void StopInGameLoadingScreen() = 0;
+
+	/**
+	 * Loading tasks are asynchronous loads the loading screen waits for after the map itself has loaded
+	 * Each task is identified by name, setting progress on a task that was not started starts it
+	 */
+	virtual void SetLoadingTaskProgress(FName TaskName, float Progress) = 0;
+
+	/** Ends a loading task, the screen goes away once the map and every task are done */
+	virtual void EndLoadingTask(FName TaskName) = 0;
 };